@@ -40,30 +40,66 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cctype>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <type_traits>
 #include <vector>
 
+#if defined(__AVX2__)
+#define JSON_LIB_AVX2 1
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_LIB_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #if _HAS_CXX17
+#include <memory_resource>
 #include <optional>
+#include <string_view>
 #include <variant>
 #else 
 #include <boost/optional.hpp>
+#include <boost/utility/string_view.hpp>
 #include <boost/variant.hpp>
 #endif
 
-#define STD_BIND_TO_THIS(__CLASS__, __METHOD__) std::bind(&__CLASS__::__METHOD__, this, std::placeholders::_1, std::placeholders::_2)
-
 #define JSON_TEMPLATE_PARAMS                                              \
 template <                                                                \
     class SymbolT,                                                        \
@@ -101,2641 +137,8709 @@ json_t< SymbolT,            \
 >
 namespace imalyavskiy
 {
-    template <
-        class SymbolT           = char,
-        class IntegerT          = int64_t,
-        class FloatingPtT       = double,
-        class BooleanT          = bool,
-        class NullT             = nullptr_t,
-        template <class _Kty, class _Ty>
-            class PairT         = std::pair,
-        template <class _Ty>
-            class LessT         = std::less,
-        template <class _Elem>
-            class CharTraitsT   = std::char_traits,
-        template <class _Ty, class _Alloc> 
-            class VectorT       = std::vector, 
-        template <class _Ty, class _Alloc>
-            class ListT         = std::list,
-        template <class _Kty, class _Ty, class _Pr, class _Alloc>
-            class MapT          = std::map,
-        template <class _Elem, class _Traits, class _Alloc>
-            class StringT       = std::basic_string,
-        template <class _Elem, class _Traits, class _Alloc>
-            class StrStrmT      = std::basic_stringstream,
-        template <class _Elem, class _Traits>
-            class IStrmT        = std::basic_istream,
-        template <class _Ty>
-            class AllocatorT    = std::allocator
-    >
-    class json_t
+    //////////////////////////////////////////////////////////////////////////
+    #pragma region -- structural classification --
+    namespace detail
     {
-    public:
-        using symbol_t          = SymbolT;
-        using integer_t         = IntegerT;
-        using floatingpt_t      = FloatingPtT;
-        using boolean_t         = BooleanT;
-        using null_t            = NullT;
+        inline unsigned trailing_zeros(const uint64_t x);
 
-        template <class _Ty> 
-            using allocator_t   = AllocatorT<_Ty>;
-        template <class _Kty, class _Ty> 
-            using pair_t        = PairT<_Kty, _Ty>;
-        template <class _Elem>
-            using char_traits_t = CharTraitsT<_Elem>;
-        template <class _Ty>
-            using less_t        = LessT<_Ty>;
-        template <class _Ty, class _Alloc = allocator_t<_Ty>> 
-            using vector_t      = VectorT<_Ty, _Alloc>;
-        template <class _Ty, class _Alloc = allocator_t<_Ty>> 
-            using list_t        = ListT<_Ty, _Alloc>;
-        template <class _Kty, class _Ty, class _Pr = less_t<_Kty>, class _Alloc = allocator_t<pair_t<const _Kty, _Ty>>> 
-            using map_t         = MapT<_Kty, _Ty, _Pr, _Alloc>;
-        template <class _Elem, class _Traits = char_traits_t<_Elem>, class _Alloc = allocator_t<_Elem>> 
-            using string_t      = StringT<_Elem, _Traits, _Alloc>;
-            using string = string_t<symbol_t>;
-        template <class _Elem, class _Traits = char_traits_t<_Elem>, class _Alloc = allocator_t<_Elem>>
-            using sstream_t     = StrStrmT<_Elem, _Traits, _Alloc>;
-            using sstream = sstream_t<symbol_t>;
-        template <class _Elem, class _Traits = char_traits_t<_Elem>>
-            using istream_t     = IStrmT<_Elem, _Traits>;
-            using istream = istream_t<symbol_t>;
+        /// The bit masks of the symbol classes of a 64 byte block, bit N stands for the byte N
+        struct block_masks
+        {
+            uint64_t quote      = 0; // "
+            uint64_t backslash  = 0; // back slash
+            uint64_t op         = 0; // { } [ ] : ,
+            uint64_t space      = 0; // space, tab, cr, lf
+        };
 
-        /// Forward declaration for JSON object data structure
-        class obj;
+#if JSON_LIB_AVX2
+        inline uint64_t eq_mask(const __m256i& lo, const __m256i& hi, const char c)
+        {
+            const __m256i v = _mm256_set1_epi8(c);
+            const uint64_t l = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v));
+            const uint64_t h = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v));
+            return l | (h << 32);
+        }
+#elif JSON_LIB_SSE2
+        inline uint64_t eq_mask(const __m128i (&v)[4], const char c)
+        {
+            const __m128i s = _mm_set1_epi8(c);
+            uint64_t r = 0;
+            for (int i = 0; i < 4; ++i)
+                r |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[i], s)) << (16 * i);
+            return r;
+        }
+#endif
 
-        /// Forward declaration for JSON array data structure
-        class arr;
+        /// Classifies the 64 byte block
+        inline void classify(const uint8_t* block, block_masks& m)
+        {
+#if JSON_LIB_AVX2
+            const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+            const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+
+            m.quote     = eq_mask(lo, hi, '"');
+            m.backslash = eq_mask(lo, hi, '\\');
+            m.op        = eq_mask(lo, hi, '{') | eq_mask(lo, hi, '}') | eq_mask(lo, hi, '[')
+                        | eq_mask(lo, hi, ']') | eq_mask(lo, hi, ':') | eq_mask(lo, hi, ',');
+            m.space     = eq_mask(lo, hi, ' ') | eq_mask(lo, hi, '\t') | eq_mask(lo, hi, '\n') | eq_mask(lo, hi, '\r');
+#elif JSON_LIB_SSE2
+            const __m128i v[4] = {
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 32)),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 48)),
+            };
 
-        /// possible results
-        enum class result_t
+            m.quote     = eq_mask(v, '"');
+            m.backslash = eq_mask(v, '\\');
+            m.op        = eq_mask(v, '{') | eq_mask(v, '}') | eq_mask(v, '[')
+                        | eq_mask(v, ']') | eq_mask(v, ':') | eq_mask(v, ',');
+            m.space     = eq_mask(v, ' ') | eq_mask(v, '\t') | eq_mask(v, '\n') | eq_mask(v, '\r');
+#else
+            m = block_masks();
+            for (int i = 0; i < 64; ++i)
+            {
+                const uint64_t bit = 1ULL << i;
+                switch (block[i])
+                {
+                case '"':   m.quote     |= bit; break;
+                case '\\':  m.backslash |= bit; break;
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                            m.op        |= bit; break;
+                case ' ': case '\t': case '\n': case '\r':
+                            m.space     |= bit; break;
+                }
+            }
+#endif
+        }
+
+        /// Bit N of the result is the xor of the bits 0..N of the argument
+        inline uint64_t prefix_xor(uint64_t x)
         {
-            s_need_more     =  3, // Need more data.
-            s_done_rpt      =  2, // Symbol successfully terminates parsing but makes no sense to current parser. Reparse symbol by above parser.
-            s_done          =  1, // Symbol successfully terminates parsing and makes sense to current parser.
-            s_ok            =  0, // General success.
-            e_fatal         = -1, // General failure.
-            e_unexpected    = -2, // Unexpected parameter or value.
-        };
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
 
-        inline static boolean_t failed(const result_t& r) { return r < result_t::s_ok; }
-        inline static boolean_t succeded(const result_t& r) { return r >= result_t::s_ok; }
+        /// The symbols preceded by an odd sequence of backslashes. The carry tells the previous block ended by such a sequence.
+        inline uint64_t escaped(const uint64_t backslash, uint64_t& carry)
+        {
+            const uint64_t even_bits    = 0x5555555555555555ULL;
+            const uint64_t odd_bits     = ~even_bits;
+            const uint64_t start_edges  = backslash & ~(backslash << 1);
+            const uint64_t even_start   = even_bits ^ carry;
+            const uint64_t even_starts  = start_edges & even_start;
+            const uint64_t odd_starts   = start_edges & ~even_start;
+            const uint64_t even_carries = backslash + even_starts;
+            uint64_t odd_carries        = backslash + odd_starts;
+            const uint64_t overflow     = odd_carries < backslash ? 1 : 0;
+
+            odd_carries |= carry;
+            carry = overflow;
+
+            const uint64_t even_carry_ends = even_carries & ~backslash;
+            const uint64_t odd_carry_ends  = odd_carries & ~backslash;
+
+            return (even_carry_ends & odd_bits) | (odd_carry_ends & even_bits);
+        }
 
-        static result_t parse(istream& input, obj& jsobj)
+        /// The length of the leading run of string symbols that need no special handling,
+        /// i.e. the position of the first quote, back slash or control symbol(or n if there is none)
+        inline size_t plain_run(const uint8_t* p, const size_t n)
         {
-            symbol_t c = 0;
-            result_t result = result_t::s_ok;
+            size_t i = 0;
+#if JSON_LIB_AVX2
+            const __m256i quote     = _mm256_set1_epi8('"');
+            const __m256i backslash = _mm256_set1_epi8('\\');
+            const __m256i control   = _mm256_set1_epi8(0x1F);
+            for (; i + 32 <= n; i += 32)
+            {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+                const __m256i special = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+                    _mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+                const uint32_t mask = (uint32_t)_mm256_movemask_epi8(special);
+                if (0 != mask)
+                    return i + trailing_zeros(mask);
+            }
+#elif JSON_LIB_SSE2
+            const __m128i quote     = _mm_set1_epi8('"');
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i control   = _mm_set1_epi8(0x1F);
+            for (; i + 16 <= n; i += 16)
+            {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+                const __m128i special = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                    _mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+                const uint32_t mask = (uint32_t)_mm_movemask_epi8(special);
+                if (0 != mask)
+                    return i + trailing_zeros(mask);
+            }
+#endif
+            for (; i < n; ++i)
+                if ('"' == p[i] || '\\' == p[i] || p[i] < 0x20)
+                    return i;
 
-            typename parser::ptr p = create();
-            if (!p)
-                return result_t::e_fatal;
+            return n;
+        }
 
-            while (input >> std::noskipws >> c || result != result_t::s_done)
+        /// The decoding table of the escape sequences: \X -> the symbol X stands for, 0 - not a single symbol escape
+        struct unescape_table
+        {
+            uint8_t map[256];
+
+            constexpr unescape_table()
+                : map()
             {
-                result = p->putchar(c, (int)input.tellg() - 1);
+                map['"']  = '"';
+                map['\\'] = '\\';
+                map['/']  = '/';
+                map['b']  = '\b';
+                map['f']  = '\f';
+                map['n']  = '\n';
+                map['r']  = '\r';
+                map['t']  = '\t';
+            }
+        };
 
-                if (result_t::s_ok > result)
-                    break;
+        /// Decodes the single symbol escape sequence \X, returns 0 if there is no such sequence
+        inline uint8_t unescape(const uint32_t c)
+        {
+            static constexpr unescape_table table;
+            return c < 256 ? table.map[c] : 0;
+        }
 
-                if (result_t::s_done == result)
-                {
-                    jsobj = p->get().get<obj>();
-                    break;
-                }
+        /// The kind of a value, defined by its first symbol
+        enum class value_kind : uint8_t
+        {
+            none,       // the symbol can not start a value
+            null,       // n
+            boolean,    // t f
+            string,     // "
+            number,     // - 0..9
+            array,      // [
+            object,     // {
+            count,      // the number of enumerators, must be the last one
+        };
+
+        /// The value kinds by the first symbol
+        struct value_kind_table
+        {
+            value_kind map[256];
+
+            constexpr value_kind_table()
+                : map()
+            {
+                map['n'] = value_kind::null;
+                map['t'] = value_kind::boolean;
+                map['f'] = value_kind::boolean;
+                map['"'] = value_kind::string;
+                map['-'] = value_kind::number;
+                for (int c = '0'; c <= '9'; ++c)
+                    map[c] = value_kind::number;
+                map['['] = value_kind::array;
+                map['{'] = value_kind::object;
             }
+        };
 
-            return result;
+        /// The kind of the value starting with the symbol c
+        inline value_kind kind_of(const uint32_t c)
+        {
+            static constexpr value_kind_table table;
+            return c < 256 ? table.map[c] : value_kind::none;
         }
 
-        static result_t parse(const string& input, obj& jsobj)
+        /// The powers of ten exactly representable by double: 1e0 - 1e22
+        inline double exact_pow10(const int32_t e)
         {
-            sstream sstr;
-            sstr.str(input);
-            return parse(sstr, jsobj);
+            static constexpr double table[] = {
+                1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+            };
+            return table[e];
         }
 
-    #pragma region -- value definition --
-        class value
-#if _HAS_CXX17
-            : public std::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>
+        /// The high 64 bits of the 128 bit product a * b, the low ones go to lo
+        inline uint64_t mul_128(const uint64_t a, const uint64_t b, uint64_t& lo)
+        {
+#if defined(__SIZEOF_INT128__)
+            const unsigned __int128 r = (unsigned __int128)a * b;
+            lo = (uint64_t)r;
+            return (uint64_t)(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+            uint64_t hi = 0;
+            lo = _umul128(a, b, &hi);
+            return hi;
 #else
-            : public boost::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>
+            const uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+            const uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+            const uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+            const uint64_t mid = (ll >> 32) + (uint32_t)lh + (uint32_t)hl;
+            lo = (mid << 32) | (uint32_t)ll;
+            return hh + (lh >> 32) + (hl >> 32) + (mid >> 32);
 #endif
+        }
+
+        /// The number of the leading zero bits, the argument must not be zero
+        inline unsigned leading_zeros(const uint64_t x)
         {
-#if _HAS_CXX17
-            using base_t = std::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>;
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long r = 0;
+            _BitScanReverse64(&r, x);
+            return 63 - (unsigned)r;
+#elif defined(__GNUC__)
+            return (unsigned)__builtin_clzll(x);
 #else
-            using base_t = boost::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>;
+            unsigned r = 0;
+            while (0 == ((x << r) >> 63))
+                ++r;
+            return r;
 #endif
-        public:
-            /// The enumeration for mnemonic correlation of indeces and types used for std::variant
-            enum class vt
-            {   /// IMPORTANT: The order of parameters is the same as value_t template parameters order
-                t_string     = 0,
-                t_object     = 1,
-                t_array      = 2,
-                t_integer    = 3,
-                t_floatingpt = 4,
-                t_boolean    = 5,
-                t_null       = 6,
-            };
-
-            static inline bool check_vt_val(const vt& v) { return (vt::t_string <= v || v <= vt::t_null); }
+        }
 
-            /// {ctor}s
-            value() { }
-            value(const string& other)      : base_t(other)         {}
-            value(const obj& other)         : base_t(other)         {}
-            value(const arr&  other)        : base_t(other)         {}
-            value(const integer_t   other)  : base_t(other)         {}
-            value(const floatingpt_t other) : base_t(other)         {}
-            value(const boolean_t other)    : base_t(other)         {}
-            value(const symbol_t* other)    : base_t(string(other)) {}
-            value(const null_t other)       : base_t(other)         {}
+        /// The 128 bit approximations of 5^q, q = smallest..largest, normalized so that the highest bit is set:
+        /// truncated for q >= 0 and rounded up for q < 0(see Lemire, "Number Parsing at a Gigabyte per Second").
+        /// Two words per power, the high one first. Computed once with a few big number operations.
+        struct powers_of_five
+        {
+            static constexpr int smallest   = -342;
+            static constexpr int largest    =  308;
 
-#if _HAS_CXX17
-            vt index() const {
-                return (vt)base_t::index();
-            }
-            template <class T>
-            T get(T* t = nullptr) const {
-                return std::get<T>(*this);
-            }
-#else            
-            vt index() const {
-                return (vt)base_t::which();
-            }
-            template <class T>
-            T get(T* t = nullptr) const {
-                return boost::get<T>(*this);
-            }
-#endif
+            uint64_t table[2 * (largest - smallest + 1)];
 
-            /// Assign operators
-            const value& operator=(const string& other)
+            powers_of_five()
             {
-                base_t::operator=(other);
-                return (*this);
-            }
+                using big = std::vector<uint32_t>; // little endian
 
-            const value& operator=(const obj& other)
-            {
-                base_t::operator=(other);
-                return (*this);
+                auto mul5 = [](big& x)
+                {
+                    uint64_t carry = 0;
+                    for (uint32_t& w : x)
+                    {
+                        const uint64_t v = (uint64_t)w * 5 + carry;
+                        w = (uint32_t)v, carry = v >> 32;
+                    }
+                    if (0 != carry)
+                        x.push_back((uint32_t)carry);
+                };
+
+                auto div5 = [](big& x)
+                {
+                    uint64_t rem = 0;
+                    for (size_t i = x.size(); i-- > 0;)
+                    {
+                        const uint64_t v = (rem << 32) | x[i];
+                        x[i] = (uint32_t)(v / 5), rem = v % 5;
+                    }
+                    while (!x.empty() && 0 == x.back())
+                        x.pop_back();
+                };
+
+                auto bit_length = [](const big& x)->int
+                {
+                    return x.empty() ? 0 : 32 * (int)x.size() - (int)leading_zeros(x.back()) + 32;
+                };
+
+                // the bits [from, from + 64) of x, the bits below zero are zeros
+                auto bits64 = [](const big& x, const int from)->uint64_t
+                {
+                    uint64_t r = 0;
+                    for (int b = from + 63; b >= from; --b)
+                        r = (r << 1) | (0 <= b && b / 32 < (int)x.size() ? (x[b / 32] >> (b % 32)) & 1 : 0);
+                    return r;
+                };
+
+                auto put = [this, &bit_length, &bits64](const int q, const big& x)
+                {
+                    const int n = bit_length(x);
+                    table[2 * (q - smallest)]       = bits64(x, n - 64);
+                    table[2 * (q - smallest) + 1]   = bits64(x, n - 128);
+                };
+
+                // q >= 0: the leading 128 bits of 5^q
+                big p5(1, 1);
+                for (int q = 0; q <= largest; ++q, mul5(p5))
+                    put(q, p5);
+
+                // q < 0: 2^b / 5^-q + 1, b is big enough to keep 128 bits. 2^b / 5^n is taken as 2^B / 5^n shifted
+                // right by B - b, the floor of a floor division is the floor of the whole one.
+                const int B = 1728;
+                big x(B / 32 + 1, 0);
+                x.back() = 1;
+                p5.assign(1, 1);
+                for (int n = 1; n <= -smallest; ++n)
+                {
+                    div5(x);
+                    mul5(p5);
+
+                    const int z = bit_length(p5); // 5^n is not a power of two: 2^(z - 1) < 5^n < 2^z
+                    const int b = n <= 27 ? z + 127 : 2 * z + 128;
+                    const int shift = B - b;
+
+                    big c(x.size() - shift / 32, 0);
+                    for (size_t i = 0; i < c.size(); ++i)
+                    {
+                        const uint64_t w = x[i + shift / 32] | (i + shift / 32 + 1 < x.size() ? (uint64_t)x[i + shift / 32 + 1] << 32 : 0);
+                        c[i] = (uint32_t)(w >> (shift % 32));
+                    }
+                    for (size_t i = 0; i < c.size() && 0 == ++c[i]; ++i); // + 1
+                    while (!c.empty() && 0 == c.back())
+                        c.pop_back();
+
+                    put(-n, c);
+                }
             }
+        };
 
-            const value& operator=(const arr& other)
+        /// Eisel-Lemire: the double nearest to w * 10^q, w != 0. Returns false in the rare cases it can not decide.
+        inline bool eisel_lemire(const int64_t q, uint64_t w, double& out)
+        {
+            static const powers_of_five powers;
+
+            const int mantissa_bits = 52;
+
+            if (q < powers_of_five::smallest)
             {
-                base_t::operator=(other);
-                return (*this);
+                out = 0;
+                return true;
             }
 
-            const value& operator=(const integer_t other)
+            if (q > powers_of_five::largest)
             {
-                base_t::operator=(other);
-                return (*this);
+                out = std::numeric_limits<double>::infinity();
+                return true;
             }
 
-            const value& operator=(const floatingpt_t other)
+            const int lz = (int)leading_zeros(w);
+            w <<= lz;
+
+            // the product with the 128 bit power of five, the lower word is only needed if the upper one is not enough
+            const uint64_t* p5 = &powers.table[2 * (q - powers_of_five::smallest)];
+            uint64_t lo = 0;
+            uint64_t hi = mul_128(w, p5[0], lo);
+            if (0x1FF == (hi & 0x1FF))
             {
-                base_t::operator=(other);
-                return (*this);
+                uint64_t lo2 = 0;
+                const uint64_t hi2 = mul_128(w, p5[1], lo2);
+                lo += hi2;
+                if (hi2 > lo)
+                    ++hi;
             }
 
-            const value& operator=(const boolean_t other)
+            if (~0ull == lo && (q < -27 || 55 < q))
+                return false;
+
+            const int upperbit = (int)(hi >> 63);
+            uint64_t mantissa = hi >> (upperbit + 64 - mantissa_bits - 3);
+            int64_t power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+
+            if (power2 <= 0)
             {
-                base_t::operator=(other);
-                return (*this);
-            }
+                // subnormal
+                if (-power2 + 1 >= 64)
+                {
+                    out = 0;
+                    return true;
+                }
 
-            const value& operator=(const symbol_t* other)
+                mantissa >>= -power2 + 1;
+                mantissa += (mantissa & 1);
+                mantissa >>= 1;
+                power2 = mantissa < (1ull << mantissa_bits) ? 0 : 1;
+            }
+            else
             {
-                base_t::operator=(string(other));
-                return (*this);
+                // exactly halfway between two doubles: round to even
+                if (lo <= 1 && -4 <= q && q <= 23 && 1 == (mantissa & 3) &&
+                    (mantissa << (upperbit + 64 - mantissa_bits - 3)) == hi)
+                    mantissa &= ~1ull;
+
+                mantissa += (mantissa & 1);
+                mantissa >>= 1;
+                if (mantissa >= (2ull << mantissa_bits))
+                {
+                    mantissa = 1ull << mantissa_bits;
+                    ++power2;
+                }
+
+                mantissa &= ~(1ull << mantissa_bits);
+                if (power2 >= 0x7FF)
+                {
+                    power2 = 0x7FF;
+                    mantissa = 0;
+                }
             }
 
-            const value& operator=(const null_t other)
+            const uint64_t bits = mantissa | ((uint64_t)power2 << mantissa_bits);
+            memcpy(&out, &bits, sizeof(out));
+            return true;
+        }
+
+        /// The value of the hexadecimal digit or -1
+        inline int hex_value(const uint32_t c)
+        {
+            if (0x30 <= c && c <= 0x39)
+                return (int)(c - 0x30);
+            if (0x41 <= c && c <= 0x46)
+                return (int)(c - 0x41 + 10);
+            if (0x61 <= c && c <= 0x66)
+                return (int)(c - 0x61 + 10);
+            return -1;
+        }
+
+        /// The index of the lowest set bit, the argument must not be zero
+        inline unsigned trailing_zeros(const uint64_t x)
+        {
+#if defined(_MSC_VER) && defined(_M_X64)
+            unsigned long r = 0;
+            _BitScanForward64(&r, x);
+            return (unsigned)r;
+#elif defined(__GNUC__)
+            return (unsigned)__builtin_ctzll(x);
+#else
+            unsigned r = 0;
+            while (0 == ((x >> r) & 1))
+                ++r;
+            return r;
+#endif
+        }
+
+        /// Tells whether the flat parser handler takes the strings without escapes as views into the input, i.e. it
+        /// declares static const bool borrows_strings = true;
+        template <class HandlerT, class = void>
+        struct borrows_strings : std::false_type {};
+
+        template <class HandlerT>
+        struct borrows_strings<HandlerT, decltype((void)HandlerT::borrows_strings)>
+            : std::integral_constant<bool, HandlerT::borrows_strings> {};
+    }
+    #pragma endregion
+    //
+    #pragma region -- arena allocator --
+    /// Monotonic bump pointer memory arena. The memory is taken from the system in blocks, every next one twice as
+    /// large up to 64 MB, deallocation does nothing and release() gives all the blocks back at once. With huge_pages
+    /// the blocks are rounded up to 2 MB and backed by the huge pages where the system allows(transparent huge pages on
+    /// Linux, the blocks are 2 MB aligned for them; large pages on Windows if the process holds the privilege),
+    /// otherwise by the normal ones.
+    /// Not thread safe, an arena serves one thread at a time.
+    class arena
+    {
+    public:
+        explicit arena(const size_t block_size = 64 * 1024, const bool huge_pages = false)
+            : m_block_size(std::max<size_t>(block_size, 4096))
+            , m_huge_pages(huge_pages)
+        {
+        }
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        ~arena() { release(); }
+
+        /// The memory of size bytes aligned to alignment(a power of 2)
+        void* allocate(const size_t size, const size_t alignment)
+        {
+            uintptr_t p = ((uintptr_t)m_cur + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
+            if (nullptr == m_cur || p + size > (uintptr_t)m_end)
             {
-                base_t::operator=(other);
-                return (*this);
+                grow(size + alignment);
+                p = ((uintptr_t)m_cur + (alignment - 1)) & ~(uintptr_t)(alignment - 1);
             }
 
-            inline bool is_string()     const { return vt::t_string     == index(); }
-            inline bool is_object()     const { return vt::t_object     == index(); }
-            inline bool is_array()      const { return vt::t_array      == index(); }
-            inline bool is_integer()    const { return vt::t_integer    == index(); }
-            inline bool is_floatingpt() const { return vt::t_floatingpt == index(); }
-            inline bool is_number()     const { return is_integer() || is_floatingpt(); };
-            inline bool is_boolean()    const { return vt::t_boolean    == index(); }
-            inline bool is_null()       const { return vt::t_null       == index(); }
+            m_cur = (char*)(p + size);
+            m_allocated += size;
+            return (void*)p;
+        }
 
-            operator obj() const
+        /// Gives all the blocks back to the system, whatever was allocated is gone
+        void release()
+        {
+            while (nullptr != m_head)
             {
-                assert(check_vt_val(index()));
+                block* const prev = m_head->prev;
+                system_free(m_head, m_head->size, m_head->huge);
+                m_head = prev;
+            }
 
-                if (index() != vt::t_object)
-                    throw std::logic_error("Not an object.");
+            m_cur = m_end = nullptr;
+            m_allocated = m_reserved = 0;
+            m_next_size = m_block_size;
+        }
 
-                return get<obj>();
-            }
+        /// The number of bytes handed out since the last release()
+        size_t allocated() const { return m_allocated; }
 
-            operator arr() const
-            {
-                assert(check_vt_val(index()));
+        /// The number of bytes taken from the system
+        size_t reserved() const { return m_reserved; }
 
-                if (index() != vt::t_array)
-                    throw std::logic_error("Not an array.");
+        /// The arena of the innermost arena_scope on the calling thread, nullptr if there is none
+        static arena* current() { return current_ref(); }
 
-                return get<arr>();
-            }
+    protected:
+        friend class arena_scope;
 
-            explicit operator string() const
-            {
-                assert(check_vt_val(index()));
+        /// The header of a block
+        struct block
+        {
+            block*  prev;
+            size_t  size;
+            bool    huge;
+        };
 
-                if (index() != vt::t_string)
-                    throw std::logic_error("Not a string.");
+        static const size_t huge_page = 2 * 1024 * 1024;
 
-                return get<string>();
-            }
+        static arena*& current_ref()
+        {
+            static thread_local arena* a = nullptr;
+            return a;
+        }
 
-            explicit operator int64_t() const
-            {
-                assert(check_vt_val(index()));
+        /// Takes the next block large enough for size bytes
+        void grow(const size_t size)
+        {
+            size_t bytes = std::max(m_next_size, size + sizeof(block));
+            if (m_huge_pages)
+                bytes = (bytes + huge_page - 1) & ~(huge_page - 1);
+
+            bool huge = m_huge_pages;
+            void* const memory = system_allocate(bytes, huge);
+            if (nullptr == memory)
+                throw std::bad_alloc();
+
+            block* const b = static_cast<block*>(memory);
+            b->prev = m_head;
+            b->size = bytes;
+            b->huge = huge;
+
+            m_head = b;
+            m_cur = static_cast<char*>(memory) + sizeof(block);
+            m_end = static_cast<char*>(memory) + bytes;
+            m_reserved += bytes;
+            m_next_size = std::min<size_t>(m_next_size * 2, 64 * 1024 * 1024);
+        }
 
-                if (index() != vt::t_integer)
-                    throw std::logic_error("Not an integer number.");
+        /// Allocates the block, huge - whether the huge pages are asked for and, on return, whether the block is to be
+        /// given back as such
+        static void* system_allocate(const size_t size, bool& huge)
+        {
+            if (!huge)
+                return std::malloc(size);
 
-                return (int64_t)get<integer_t>();
+#if defined(_WIN32)
+            const size_t large_page = ::GetLargePageMinimum();
+            if (0 != large_page && 0 == size % large_page)
+            {
+                void* const memory = ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (nullptr != memory)
+                    return memory;
             }
 
-            explicit operator floatingpt_t() const
-            {
-                assert(check_vt_val(index()));
+            return ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+            // mmap gives the normal page alignment only, the huge page more is mapped and the unaligned head and tail
+            // are given back
+            void* const memory = ::mmap(nullptr, size + huge_page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (MAP_FAILED == memory)
+                return nullptr;
+
+            char* const begin = static_cast<char*>(memory);
+            char* const aligned = (char*)(((uintptr_t)begin + huge_page - 1) & ~(uintptr_t)(huge_page - 1));
+            if (aligned != begin)
+                ::munmap(begin, aligned - begin);
+            if (aligned + size != begin + size + huge_page)
+                ::munmap(aligned + size, begin + huge_page - aligned);
+#if defined(MADV_HUGEPAGE)
+            ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+            return aligned;
+#endif
+        }
 
-                if (index() != vt::t_floatingpt)
-                    throw std::logic_error("Not a floating pointer number.");
+        static void system_free(void* memory, const size_t size, const bool huge)
+        {
+            if (!huge)
+                return std::free(memory);
 
-                return get<floatingpt_t>();
-            }
+#if defined(_WIN32)
+            (void)size;
+            ::VirtualFree(memory, 0, MEM_RELEASE);
+#else
+            ::munmap(memory, size);
+#endif
+        }
 
-            explicit operator boolean_t() const
-            {
-                assert(check_vt_val(index()));
+        const size_t    m_block_size;
+        const bool      m_huge_pages;
+        size_t          m_next_size     = m_block_size;
+        block*          m_head          = nullptr;
+        char*           m_cur           = nullptr;
+        char*           m_end           = nullptr;
+        size_t          m_allocated     = 0;
+        size_t          m_reserved      = 0;
+    };
 
-                if (index() != vt::t_boolean)
-                    throw std::logic_error("Not a boolean.");
+    /// Makes the arena the current one of the calling thread for the lifetime of the scope, the scopes nest
+    class arena_scope
+    {
+    public:
+        explicit arena_scope(arena& a)
+            : m_prev(arena::current_ref())
+        {
+            arena::current_ref() = &a;
+        }
 
-                return get<boolean_t>();
-            }
+        arena_scope(const arena_scope&) = delete;
+        arena_scope& operator=(const arena_scope&) = delete;
 
-            explicit operator null_t() const
-            {
-                assert(check_vt_val(index()));
+        ~arena_scope() { arena::current_ref() = m_prev; }
 
-                if (index() != vt::t_null)
-                    throw std::logic_error("Not a null.");
+    protected:
+        arena* const m_prev;
+    };
 
-                return get<null_t>();
-            }
+    /// Stateful allocator for the json_t AllocatorT parameter. json_t creates its containers with the default
+    /// constructed allocators, so the allocator binds itself to the current arena(see arena_scope) on construction
+    /// and keeps it: whatever is built within a scope lives in its arena, including the parser internals, and is
+    /// given back by the arena at once. Out of any scope it falls back to the global heap.
+    /// The copy of a container binds to the arena current at the moment of copying, the moved container keeps its own.
+    template <class T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::false_type;
+        using propagate_on_container_swap = std::true_type;
 
-            value operator[](const string& key) 
-            {
-                return operator obj()[key];
-            }
+        arena_allocator()
+            : m_arena(arena::current())
+        {
+        }
 
-            value operator[](const size_t& idx) 
-            {
-                return operator arr()[idx];
-            }
+        explicit arena_allocator(arena* a)
+            : m_arena(a)
+        {
+        }
 
-            explicit operator int32_t() const
-            {
-                return (int32_t)(operator int64_t());
-            }
+        template <class U>
+        arena_allocator(const arena_allocator<U>& other)
+            : m_arena(other.get_arena())
+        {
+        }
 
-            explicit operator int16_t() const
-            {
-                return (int16_t)(operator int64_t());
-            }
-        };
+        T* allocate(const size_t n)
+        {
+            if (nullptr == m_arena)
+                return static_cast<T*>(::operator new(n * sizeof(T)));
+
+            return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, const size_t)
+        {
+            if (nullptr == m_arena)
+                ::operator delete(p);
+        }
+
+        arena_allocator select_on_container_copy_construction() const { return arena_allocator(); }
+
+        /// The arena, nullptr - the global heap
+        arena* get_arena() const { return m_arena; }
+
+        template <class U>
+        bool operator==(const arena_allocator<U>& other) const { return m_arena == other.get_arena(); }
 
+        template <class U>
+        bool operator!=(const arena_allocator<U>& other) const { return m_arena != other.get_arena(); }
+
+    protected:
+        arena* m_arena;
+    };
     #pragma endregion
     //
-    #pragma region -- json data declaration --
-        template<class BaseType>
-        class container
-            : public BaseType
+    #pragma region -- flat map --
+    /// Sorted vector map for the json_t MapT parameter(see flat_json). The members are kept in one contiguous block
+    /// ordered by the key: the lookup is a binary search over the adjacent keys, the iteration is a walk over the block
+    /// and the insertion moves the greater members up. Fits the small objects, which are the most, the insertion into
+    /// the large ones is linear.
+    template <class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<std::pair<const Key, T>>>
+    class flat_map
+    {
+    public:
+        using key_type          = Key;
+        using mapped_type       = T;
+        using value_type        = std::pair<Key, T>;
+        using key_compare       = Compare;
+        using allocator_type    = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+        using storage_t         = std::vector<value_type, allocator_type>;
+        using size_type         = typename storage_t::size_type;
+        using difference_type   = typename storage_t::difference_type;
+        using reference         = value_type&;
+        using const_reference   = const value_type&;
+        using iterator          = typename storage_t::iterator;
+        using const_iterator    = typename storage_t::const_iterator;
+
+        flat_map() = default;
+        flat_map(const flat_map& other) = default;
+        flat_map(flat_map&& other) = default;
+
+        explicit flat_map(const allocator_type& a) : m_members(a) {}
+        flat_map(const flat_map& other, const allocator_type& a) : m_members(other.m_members, a), m_less(other.m_less) {}
+        flat_map(flat_map&& other, const allocator_type& a) : m_members(std::move(other.m_members), a), m_less(other.m_less) {}
+
+        flat_map(std::initializer_list<value_type> l)
         {
-        public:
-            using my_base_t = BaseType;
+            for (const value_type& member : l)
+                insert(member);
+        }
 
-            /// {ctor}s
-            container() = default;
-            container(std::initializer_list<value> l) : BaseType(l) {}
+        flat_map& operator=(const flat_map& other) = default;
+        flat_map& operator=(flat_map&& other) = default;
 
-            virtual const string str(sstream& str = stream()) const = 0;
+        iterator begin()                { return m_members.begin(); }
+        iterator end()                  { return m_members.end(); }
+        const_iterator begin() const    { return m_members.begin(); }
+        const_iterator end() const      { return m_members.end(); }
+        const_iterator cbegin() const   { return m_members.cbegin(); }
+        const_iterator cend() const     { return m_members.cend(); }
 
-            protected:
-                string serialize_string(const string& s) const
-                {
-                    string r;
+        bool empty() const              { return m_members.empty(); }
+        size_type size() const          { return m_members.size(); }
+        void clear()                    { m_members.clear(); }
+        void reserve(const size_type n) { m_members.reserve(n); }
 
-                    for (symbol_t c : s)
-                    {
-                        switch (c)
-                        {
-                        case '\b':          // backspace
-                            r += "\\b";
-                            break;
-                        case '\f':          // form feed
-                            r += "\\f";
-                            break;
-                        case '\n':          // new line
-                            r += "\\n";
-                            break;
-                        case '\r':          // carriage return
-                            r += "\\r";
-                            break;
-                        case '\t':          // horizontal tab
-                            r += "\\t";
-                            break;
-                        case '\\':          // back slash
-                            r += "\\\\";
-                            break;
-                        case '/':           // forward slash
-                            r += "\\/";
-                            break;
-                        // TODO: needed to properly serialize unicode(2-byte) symbols
-                        default:
-                            r.push_back(c); // all other
-                            break;
-                        }
-                    }
+        allocator_type get_allocator() const { return m_members.get_allocator(); }
 
-                    return r;
-                }
-        };
+        /// The first member not less than the key
+        iterator lower_bound(const Key& key)
+        {
+            return std::lower_bound(begin(), end(), key, [this](const value_type& m, const Key& k) { return m_less(m.first, k); });
+        }
 
-        /// Declaration of the object JSON data structure
-        class obj 
-            : public container<map_t<string, value>>
+        const_iterator lower_bound(const Key& key) const
         {
-        public:
-            // constant iterator type 
-            typedef typename container<map_t<string, value>>::my_base_t::const_iterator cit;
+            return std::lower_bound(begin(), end(), key, [this](const value_type& m, const Key& k) { return m_less(m.first, k); });
+        }
 
-            // iterator type
-            typedef typename container<map_t<string, value>>::my_base_t::iterator it;
+        iterator find(const Key& key)
+        {
+            const iterator it = lower_bound(key);
+            return (end() != it && !m_less(key, it->first)) ? it : end();
+        }
 
-            // default constructor
-            obj() = default;
+        const_iterator find(const Key& key) const
+        {
+            const const_iterator it = lower_bound(key);
+            return (end() != it && !m_less(key, it->first)) ? it : end();
+        }
 
-            // initializers list constructor
-            obj(std::initializer_list<pair_t<string, value>> l);
+        size_type count(const Key& key) const { return end() != find(key) ? 1 : 0; }
 
-            // random access operator 
-            value& operator[](const string& key)
-            {
-                return container::operator[](key);
-            }
+        T& at(const Key& key)
+        {
+            const iterator it = find(key);
+            if (end() == it)
+                throw std::out_of_range("flat_map::at");
+            return it->second;
+        }
 
-            // constant random access operator
-            const value& operator[](const string& key) const
-            {
-                return container::at(key);
-            }
+        const T& at(const Key& key) const
+        {
+            const const_iterator it = find(key);
+            if (end() == it)
+                throw std::out_of_range("flat_map::at");
+            return it->second;
+        }
 
-            // certain key presence test
-            boolean_t exists(const string& key) const
-            {
-                return end() != find(key);
-            }
+        T& operator[](const Key& key) { return try_emplace(key).first->second; }
 
-            // convert to string
-            operator string() const
+        T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
+
+        /// Inserts the member if there is no such key, otherwise returns the present one
+        template <class K, class... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            // the keys in order are appended without the search
+            if (m_members.empty() || m_less(m_members.back().first, key))
             {
-                return str();
+                m_members.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                       std::forward_as_tuple(std::forward<Args>(args)...));
+                return std::make_pair(--end(), true);
             }
 
-            /// serialization
-            virtual const string str(sstream& str = sstream()) const final;
-        };
+            const iterator it = lower_bound(key);
+            if (end() != it && !m_less(key, it->first))
+                return std::make_pair(it, false);
 
-        /// Declaration of the array JSON data structure
-        class arr 
-            : public container<vector_t<value>>
-        {
-        public:
-            // constant iterator type
-            typedef typename container<vector_t<value>>::my_base_t::const_iterator cit;
+            return std::make_pair(m_members.emplace(it, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                                    std::forward_as_tuple(std::forward<Args>(args)...)), true);
+        }
 
-            // iterator
-            typedef typename container<vector_t<value>>::my_base_t::iterator it;
+        std::pair<iterator, bool> insert(const value_type& member) { return try_emplace(member.first, member.second); }
 
-            // default constructor type
-            arr() = default;
+        std::pair<iterator, bool> insert(value_type&& member) { return try_emplace(std::move(member.first), std::move(member.second)); }
 
-            // initializer list constructor
-            arr(std::initializer_list<value> l);
+        template <class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            value_type member(std::forward<Args>(args)...);
+            return insert(std::move(member));
+        }
 
-            // convert to string
-            operator string() const
-            {
-                return str();
-            }
+        iterator erase(const_iterator pos) { return m_members.erase(pos); }
 
-            // serialization
-            virtual const string str(sstream& str = sstream()) const final;
-        };
-    #pragma endregion
-    //
-    #pragma region -- parser interface --
-        /// Common parser interface
-        class parser
+        size_type erase(const Key& key)
         {
-        public:
-            typedef std::shared_ptr<parser> ptr;
+            const iterator it = find(key);
+            if (end() == it)
+                return 0;
 
-            virtual ~parser() {};
+            m_members.erase(it);
+            return 1;
+        }
 
-            /// Drops the internal state to initial(i.e. as just constructed)
-            virtual void        reset() = 0;
+        void swap(flat_map& other)
+        {
+            m_members.swap(other.m_members);
+            std::swap(m_less, other.m_less);
+        }
 
-            /// Puts a character to the parsing routine
-            virtual result_t    putchar(const symbol_t& c, const int pos) = 0;
+        bool operator==(const flat_map& other) const { return m_members == other.m_members; }
+        bool operator!=(const flat_map& other) const { return m_members != other.m_members; }
 
-            /// Retrieves the parsing result
-            virtual value       get() const = 0;
-        };
+    protected:
+        storage_t   m_members;
+        Compare     m_less;
+    };
     #pragma endregion
     //
-    #pragma region -- parser_base -- 
-    #pragma region -- state machine types --
-        using state_change_handler_t = std::function<result_t(const symbol_t&, const int)>;
-
-        template <typename READSTATE, typename _STATE_CHANGE_HANDLER>
-        using TTransition = pair_t<READSTATE, _STATE_CHANGE_HANDLER>;
+    #pragma region -- hash map --
+    namespace detail
+    {
+        /// 64 bit hash of the bytes [data, data + len), 8 bytes a step
+        inline uint64_t hash_bytes(const void* data, const size_t len)
+        {
+            static const uint64_t k0 = 0x9E3779B97F4A7C15ull;
+            static const uint64_t k1 = 0xBF58476D1CE4E5B9ull;
 
-        template<typename STATE, typename STATE_CHANGE_HANDLER>
-        using Transition = TTransition<STATE, STATE_CHANGE_HANDLER>;
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            uint64_t h = k0 ^ (len * k1);
 
-        template <typename EVENT, typename TRANSITION>
-        using TTransitionTable = map_t<typename EVENT, typename TRANSITION>;
+            size_t n = len;
+            for (; n >= 8; n -= 8, p += 8)
+            {
+                uint64_t w = 0;
+                memcpy(&w, p, 8);
+                h = (h ^ (w * k1)) * k0;
+                h ^= h >> 29;
+            }
 
-        template<typename STATE, typename EVENT, typename STATE_CHANGE_HANDLER>
-        using TransitionTable = TTransitionTable<EVENT, Transition<STATE, STATE_CHANGE_HANDLER>>;
+            uint64_t w = 0;
+            memcpy(&w, p, n);
+            h = (h ^ (w * k1)) * k0;
 
-        template <typename READSTATE, typename TRANSITION_TABLE = TransitionTable>
-        using TStateTable = map_t<READSTATE, TRANSITION_TABLE>;
+            h ^= h >> 32;
+            h *= k1;
+            h ^= h >> 29;
+            return h;
+        }
+    }
 
-        template<typename STATE, typename EVENT, typename STATE_CHANGE_HANDLER = state_change_handler_t>
-        using StateTable = TStateTable<STATE, TransitionTable<STATE, EVENT, STATE_CHANGE_HANDLER>>;
-    #pragma endregion
-        template<typename STATE, STATE initial_state>
-        class state
+    /// Open addressing hash map for the json_t MapT parameter(see hash_json), for the objects of thousands of keys. The
+    /// members are kept in one vector in the insertion(i.e. the document) order, the index is a power of 2 table of
+    /// the slots with linear probing, a slot keeps the member index next to the upper half of the key hash, so the
+    /// probes compare the keys of the matching hashes only. The key hashes are cached as well, the index is rebuilt
+    /// on growth without hashing the keys again. Up to index_threshold members there is no index, the lookup walks
+    /// the cached hashes, i.e. the small objects are flat.
+    /// The keys are the symbol strings(data() and size()) compared for equality only, Compare is taken for the MapT
+    /// signature and is not used.
+    template <class Key, class T, class Compare = std::less<Key>, class Alloc = std::allocator<std::pair<const Key, T>>>
+    class hash_map
+    {
+    public:
+        using key_type          = Key;
+        using mapped_type       = T;
+        using value_type        = std::pair<Key, T>;
+        using allocator_type    = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+        using storage_t         = std::vector<value_type, allocator_type>;
+        using size_type         = typename storage_t::size_type;
+        using difference_type   = typename storage_t::difference_type;
+        using reference         = value_type&;
+        using const_reference   = const value_type&;
+        using iterator          = typename storage_t::iterator;
+        using const_iterator    = typename storage_t::const_iterator;
+
+        /// The number of members the index is built from
+        static const size_t index_threshold = 16;
+
+        hash_map() = default;
+        hash_map(const hash_map& other) = default;
+        hash_map(hash_map&& other) = default;
+
+        explicit hash_map(const allocator_type& a)
+            : m_members(a), m_hashes(typename hashes_t::allocator_type(a)), m_slots(typename slots_t::allocator_type(a)) {}
+        hash_map(const hash_map& other, const allocator_type& a)
+            : m_members(other.m_members, a), m_hashes(other.m_hashes, a), m_slots(other.m_slots, a) {}
+        hash_map(hash_map&& other, const allocator_type& a)
+            : m_members(std::move(other.m_members), a), m_hashes(std::move(other.m_hashes), a), m_slots(std::move(other.m_slots), a) {}
+
+        hash_map(std::initializer_list<value_type> l)
         {
-        private:
-            STATE m_state = initial_state;
-
-        protected:
-            STATE get() const { return m_state; };
-            void set(STATE new_state) { m_state = new_state; }
-        };
+            for (const value_type& member : l)
+                insert(member);
+        }
 
-        template<class ValueT, class EventsT, class StateT, StateT initial_state>
-        class parser_impl
-            : protected state<StateT, initial_state>
-            , public parser
-        {
-        public:
-            using event_t = EventsT;
-            using StateTable_t = StateTable<StateT, EventsT>;
+        hash_map& operator=(const hash_map& other) = default;
+        hash_map& operator=(hash_map&& other) = default;
 
-            parser_impl() {};
+        iterator begin()                { return m_members.begin(); }
+        iterator end()                  { return m_members.end(); }
+        const_iterator begin() const    { return m_members.begin(); }
+        const_iterator end() const      { return m_members.end(); }
+        const_iterator cbegin() const   { return m_members.cbegin(); }
+        const_iterator cend() const     { return m_members.cend(); }
 
-            // The step of the automata
-            result_t step(const event_t& e, const symbol_t& c, const int pos)
-            {
-                auto transition_group = table().at(state::get());
-                if (transition_group.end() != transition_group.find(e))
-                {
-                    auto transition = transition_group.at(e);
-                    assert(transition.second);
-                    result_t res = transition.second(c, pos);
+        bool empty() const              { return m_members.empty(); }
+        size_type size() const          { return m_members.size(); }
 
-                    state::set(transition.first);
+        void clear()
+        {
+            m_members.clear();
+            m_hashes.clear();
+            m_slots.clear();
+        }
 
-                    return res;
-                }
+        void reserve(const size_type n)
+        {
+            m_members.reserve(n);
+            m_hashes.reserve(n);
+            if (n > index_threshold)
+                rehash(slots_for(n));
+        }
 
-                return result_t::e_unexpected;
-            }
+        allocator_type get_allocator() const { return m_members.get_allocator(); }
 
-        protected:
-            virtual event_t to_event(const symbol_t& c) const = 0;
-            virtual event_t to_event(const result_t& c) const = 0;
+        /// The hash of the key
+        static uint64_t hash(const Key& key) { return detail::hash_bytes(key.data(), key.size() * sizeof(*key.data())); }
 
-            virtual const StateTable_t& table() = 0;
+        iterator find(const Key& key)               { return begin() + locate(key, hash(key)); }
+        const_iterator find(const Key& key) const   { return begin() + locate(key, hash(key)); }
 
-            template <class V>
-            class optional
-                : public
-#if _HAS_CXX17
-                std::optional<V>
-#else
-                boost::optional<V>
-#endif
-            {
-            public:
-                operator bool() const
-                {
-#if _HAS_CXX17
-                    return has_value();
-#else
-                    return is_initialized();
-#endif
-                }
-            };
-            
-            optional<ValueT> m_value;
-        };
-    #pragma endregion
-    //////////////////////////////////////////////////////////////////////////
-    #pragma region -- string parser declaration -- 
-        enum class e_string_states
-        {
-            initial,    // wait for " and skipping space charscters - space, hrisontal tab, crlf, lf
-            inside,
-            escape,
-            unicode_1,
-            unicode_2,
-            unicode_3,
-            unicode_4,
-            done,
-            failure,
-        };
+        size_type count(const Key& key) const { return end() != find(key) ? 1 : 0; }
 
-        enum class e_string_events
+        T& at(const Key& key)
         {
-            symbol,
-            hex_digit,
-            quote,
-            back_slash,
-            slash,
-            alpha_b,    // stands for backspace
-            alpha_f,    // stands for form feed
-            alpha_n,    // stands for new line
-            alpha_r,    // stands for carriage return
-            alpha_t,    // stands for tab
-            alpha_u,    // stands for unicode
-        };
+            const iterator it = find(key);
+            if (end() == it)
+                throw std::out_of_range("hash_map::at");
+            return it->second;
+        }
 
-        class string_parser_t
-            : public parser_impl<string, e_string_events, e_string_states, e_string_states::initial>
+        const T& at(const Key& key) const
         {
-        public:
-            using event_t               = e_string_events;
-            using state_t               = e_string_states;
-            using EventToStateTable_t   = StateTable<state_t, event_t>;
-
-            string_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial,   { { event_t::quote,      { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_initial ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::inside,    { { event_t::quote,      { state_t::done,      STD_BIND_TO_THIS( string_parser_t, on_done    ) } },
-                                        { event_t::back_slash, { state_t::escape,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::symbol,     { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_inside  ) } },
-                } },
-                { state_t::escape,    { { event_t::quote,      { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::back_slash, { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::slash,      { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_b,    { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_f,    { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_n,    { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_r,    { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_t,    { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_escape  ) } },
-                                        { event_t::alpha_u,    { state_t::unicode_1, STD_BIND_TO_THIS( string_parser_t, on_unicode ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::unicode_1, { { event_t::hex_digit,  { state_t::unicode_2, STD_BIND_TO_THIS( string_parser_t, on_unicode ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::unicode_2, { { event_t::hex_digit,  { state_t::unicode_3, STD_BIND_TO_THIS( string_parser_t, on_unicode ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::unicode_3, { { event_t::hex_digit,  { state_t::unicode_4, STD_BIND_TO_THIS( string_parser_t, on_unicode ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::unicode_4, { { event_t::hex_digit,  { state_t::inside,    STD_BIND_TO_THIS( string_parser_t, on_inside  ) } },
-                                        { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::done,      { { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-                { state_t::failure,   { { event_t::symbol,     { state_t::failure,   STD_BIND_TO_THIS( string_parser_t, on_fail    ) } },
-                } },
-            } {};
-
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
+            const const_iterator it = find(key);
+            if (end() == it)
+                throw std::out_of_range("hash_map::at");
+            return it->second;
+        }
 
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
+        T& operator[](const Key& key) { return try_emplace(key).first->second; }
 
-            virtual value get() const final;
+        T& operator[](Key&& key) { return try_emplace(std::move(key)).first->second; }
 
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+        /// Inserts the member if there is no such key, otherwise returns the present one
+        template <class K, class... Args>
+        std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+        {
+            const uint64_t h = hash(key);
 
-            virtual event_t to_event(const symbol_t& c) const override;
+            const size_t idx = locate(key, h);
+            if (idx != m_members.size())
+                return std::make_pair(begin() + idx, false);
 
-            virtual event_t to_event(const result_t& c) const override;
+            m_members.emplace_back(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                                   std::forward_as_tuple(std::forward<Args>(args)...));
+            m_hashes.push_back(h);
 
-            // Own methods
-            result_t on_initial(const symbol_t&c, const int pos);
+            // once there is an index(past the threshold or reserved) every member is in it
+            if (!m_slots.empty() || m_members.size() > index_threshold)
+            {
+                if (m_members.size() * 2 > m_slots.size())
+                    rehash(slots_for(m_members.size()));
+                else
+                    place(h, idx);
+            }
 
-            result_t on_inside(const symbol_t&c, const int pos);
+            return std::make_pair(begin() + idx, true);
+        }
 
-            result_t on_escape(const symbol_t&c, const int pos);
+        std::pair<iterator, bool> insert(const value_type& member) { return try_emplace(member.first, member.second); }
 
-            result_t on_unicode(const symbol_t&c, const int pos);
+        std::pair<iterator, bool> insert(value_type&& member) { return try_emplace(std::move(member.first), std::move(member.second)); }
 
-            result_t on_done(const symbol_t&c, const int pos);
+        template <class... Args>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            value_type member(std::forward<Args>(args)...);
+            return insert(std::move(member));
+        }
 
-            result_t on_fail(const symbol_t&c, const int pos);
+        /// Removes the member keeping the order of the rest, linear(the greater members move down)
+        iterator erase(const_iterator pos)
+        {
+            const size_t idx = pos - cbegin();
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
+            if (!m_slots.empty())
+            {
+                unplace(idx);
 
-            string m_cache;
-        };
-    #pragma endregion
-    //
-    #pragma region -- number parser declaration -- 
-        enum class e_number_states
-        {
-            initial,
-            leading_minus,
-            zero,
-            decimal_dot,
-            integer,
-            fractional,
-            exponent_delim,
-            exponent_sign,
-            exponent_val,
-            done,
-            failure,
-        };
+                // the members after the erased one move down by one
+                for (uint64_t& slot : m_slots)
+                {
+                    if (0 != slot && (size_t)(slot & 0xFFFFFFFFull) - 1 > idx)
+                        --slot;
+                }
+            }
 
-        enum class e_number_events
-        {
-            // ascii part
-            minus,      // -
-            plus,       // +
-            dec_zero,   // 0
-            dec_digit,  // 0x31 - 0x39
-            dot,        // .
-            exponent,   // E or 0x65 - e
-            symbol,
-        };
+            m_hashes.erase(m_hashes.begin() + idx);
+            return m_members.erase(m_members.begin() + idx);
+        }
 
-        struct number
+        size_type erase(const Key& key)
         {
-            number()
-                : m_positive(true)
-                , m_integer(0)
-                , m_fractional_value(0)
-                , m_has_exponent(false)
-                , m_exponent_positive(true)
-                , m_exponent_value(0)
-            {}
+            const iterator it = find(key);
+            if (end() == it)
+                return 0;
 
-            boolean_t   m_positive;
-            integer_t   m_integer;
-            integer_t   m_fractional_value;
-            integer_t   m_fractional_digits;
-            boolean_t   m_has_exponent;
-            boolean_t   m_exponent_positive;
-            integer_t   m_exponent_value;
-        };
+            erase(const_iterator(it));
+            return 1;
+        }
 
-        class number_parser_t
-            : public parser_impl<number, e_number_events, e_number_states, e_number_states::initial>
+        void swap(hash_map& other)
         {
-            using event_t = e_number_events;
-            using state_t = e_number_states;
-            using EventToStateTable_t = StateTable<state_t, event_t>;
-        
-        public:
-            number_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial,        { { event_t::minus,     { state_t::leading_minus,  STD_BIND_TO_THIS( number_parser_t, on_minus      ) } },
-                                             { event_t::dec_zero,  { state_t::zero,           STD_BIND_TO_THIS( number_parser_t, on_zero       ) } },
-                                             { event_t::dec_digit, { state_t::integer,        STD_BIND_TO_THIS( number_parser_t, on_integer    ) } },
-                                             { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::leading_minus,  { { event_t::dec_zero,  { state_t::zero,           STD_BIND_TO_THIS( number_parser_t, on_zero       ) } },
-                                             { event_t::dec_digit, { state_t::integer,        STD_BIND_TO_THIS( number_parser_t, on_integer    ) } },
-                                             { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::zero,           { { event_t::dot,       { state_t::decimal_dot,    STD_BIND_TO_THIS( number_parser_t, on_dot        ) } },
-                                             { event_t::symbol,    { state_t::done,           STD_BIND_TO_THIS( number_parser_t, on_done       ) } },
-                } },
-                { state_t::decimal_dot,    { { event_t::dec_zero,  { state_t::fractional,     STD_BIND_TO_THIS( number_parser_t, on_fractional ) } },
-                                             { event_t::dec_digit, { state_t::fractional,     STD_BIND_TO_THIS( number_parser_t, on_fractional ) } },
-                                             { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::integer,        { { event_t::dec_zero,  { state_t::integer,        STD_BIND_TO_THIS( number_parser_t, on_integer    ) } },
-                                             { event_t::dec_digit, { state_t::integer,        STD_BIND_TO_THIS( number_parser_t, on_integer    ) } },
-                                             { event_t::dot,       { state_t::decimal_dot,    STD_BIND_TO_THIS( number_parser_t, on_dot        ) } },
-                                             { event_t::symbol,    { state_t::done,           STD_BIND_TO_THIS( number_parser_t, on_done       ) } },
-                } },
-                { state_t::fractional,     { { event_t::dec_zero,  { state_t::fractional,     STD_BIND_TO_THIS( number_parser_t, on_fractional ) } },
-                                             { event_t::dec_digit, { state_t::fractional,     STD_BIND_TO_THIS( number_parser_t, on_fractional ) } },
-                                             { event_t::exponent,  { state_t::exponent_delim, STD_BIND_TO_THIS( number_parser_t, on_exponent   ) } },
-                                             { event_t::symbol,    { state_t::done,           STD_BIND_TO_THIS( number_parser_t, on_done       ) } },
-                } },
-                { state_t::exponent_delim, { { event_t::minus,     { state_t::exponent_sign,  STD_BIND_TO_THIS( number_parser_t, on_exp_sign   ) } },
-                                             { event_t::plus,      { state_t::exponent_sign,  STD_BIND_TO_THIS( number_parser_t, on_exp_sign   ) } },
-                                             { event_t::dec_zero,  { state_t::exponent_delim, STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::dec_digit, { state_t::exponent_delim, STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::exponent_sign,  { { event_t::dec_zero,  { state_t::exponent_val,   STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::dec_digit, { state_t::exponent_val,   STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::exponent_val,   { { event_t::dec_zero,  { state_t::exponent_val,   STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::dec_digit, { state_t::exponent_val,   STD_BIND_TO_THIS( number_parser_t, on_exp_value  ) } },
-                                             { event_t::symbol,    { state_t::done,           STD_BIND_TO_THIS( number_parser_t, on_done       ) } },
-                } },
-                { state_t::done,           { { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-                { state_t::failure,        { { event_t::symbol,    { state_t::failure,        STD_BIND_TO_THIS( number_parser_t, on_fail       ) } },
-                } },
-            } {};
-
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
+            m_members.swap(other.m_members);
+            m_hashes.swap(other.m_hashes);
+            m_slots.swap(other.m_slots);
+        }
 
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
+        bool operator==(const hash_map& other) const { return m_members == other.m_members; }
+        bool operator!=(const hash_map& other) const { return m_members != other.m_members; }
 
-            virtual value get() const final;
+    protected:
+        using hashes_t  = std::vector<uint64_t, typename std::allocator_traits<Alloc>::template rebind_alloc<uint64_t>>;
+        using slots_t   = std::vector<uint64_t, typename std::allocator_traits<Alloc>::template rebind_alloc<uint64_t>>;
 
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+        /// The power of 2 table size keeping the load under 1/2
+        static size_t slots_for(const size_t members)
+        {
+            size_t n = 2 * index_threshold;
+            while (n < members * 2)
+                n *= 2;
+            return n;
+        }
 
-            virtual event_t to_event(const symbol_t& c) const override;
+        /// The slot: the upper half of the hash | the member index + 1, 0 - empty
+        static uint64_t slot_of(const uint64_t h, const size_t idx) { return (h & 0xFFFFFFFF00000000ull) | (uint64_t)(idx + 1); }
 
-            virtual event_t to_event(const result_t& c) const override;
+        /// The index of the member with the key or size() if there is none
+        size_t locate(const Key& key, const uint64_t h) const
+        {
+            if (m_slots.empty())
+            {
+                for (size_t i = 0; i < m_hashes.size(); ++i)
+                {
+                    if (h == m_hashes[i] && key == m_members[i].first)
+                        return i;
+                }
 
-            // Own methods
-            result_t on_initial(const symbol_t& c, const int pos);
+                return m_members.size();
+            }
 
-            result_t on_minus(const symbol_t& c, const int pos);
+            const size_t mask = m_slots.size() - 1;
+            const uint64_t upper = h & 0xFFFFFFFF00000000ull;
+            for (size_t i = (size_t)h & mask; 0 != m_slots[i]; i = (i + 1) & mask)
+            {
+                const uint64_t slot = m_slots[i];
+                if (upper == (slot & 0xFFFFFFFF00000000ull))
+                {
+                    const size_t idx = (size_t)(slot & 0xFFFFFFFFull) - 1;
+                    if (key == m_members[idx].first)
+                        return idx;
+                }
+            }
 
-            result_t on_integer(const symbol_t& c, const int pos);
+            return m_members.size();
+        }
 
-            result_t on_fractional(const symbol_t& c, const int pos);
+        /// Puts the member to the first free slot of its probe sequence
+        void place(const uint64_t h, const size_t idx)
+        {
+            const size_t mask = m_slots.size() - 1;
 
-            result_t on_exponent(const symbol_t& c, const int pos);
+            size_t i = (size_t)h & mask;
+            while (0 != m_slots[i])
+                i = (i + 1) & mask;
 
-            result_t on_exp_sign(const symbol_t& c, const int pos);
+            m_slots[i] = slot_of(h, idx);
+        }
 
-            result_t on_exp_value(const symbol_t& c, const int pos);
+        /// Frees the slot of the member by the backward shift: the members of the probe sequence after it move back
+        /// unless that takes them before their home slot, so the probes need no tombstones
+        void unplace(const size_t idx)
+        {
+            const size_t mask = m_slots.size() - 1;
 
+            size_t hole = (size_t)m_hashes[idx] & mask;
+            while ((size_t)(m_slots[hole] & 0xFFFFFFFFull) - 1 != idx)
+                hole = (hole + 1) & mask;
 
-            result_t on_zero(const symbol_t& c, const int pos);
+            m_slots[hole] = 0;
+            for (size_t i = (hole + 1) & mask; 0 != m_slots[i]; i = (i + 1) & mask)
+            {
+                const size_t home = (size_t)m_hashes[(size_t)(m_slots[i] & 0xFFFFFFFFull) - 1] & mask;
 
-            result_t on_dot(const symbol_t& c, const int pos);
+                // the member stays if its home is cyclically within (hole, i]
+                if (((i - home) & mask) < ((i - hole) & mask))
+                    continue;
 
-            result_t on_done(const symbol_t& c, const int pos);
+                m_slots[hole] = m_slots[i];
+                m_slots[i] = 0;
+                hole = i;
+            }
+        }
 
-            result_t on_fail(const symbol_t& c, const int pos);
+        /// Rebuilds the index of n slots by the cached hashes
+        void rehash(const size_t n)
+        {
+            if (n <= m_slots.size())
+                return;
 
-            static result_t append_digit(integer_t& val, const symbol_t& c);
+            m_slots.assign(n, 0);
+            for (size_t idx = 0; idx < m_hashes.size(); ++idx)
+                place(m_hashes[idx], idx);
+        }
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
-        };
+        storage_t   m_members;
+        hashes_t    m_hashes;   // the key hashes of the members
+        slots_t     m_slots;    // the index, empty up to index_threshold members
+    };
     #pragma endregion
     //
-    #pragma region -- null parser declaration -- 
-        enum class e_null_states
+#if _HAS_CXX17
+    #pragma region -- memory resource allocator --
+    /// Makes the memory resource the current one of the calling thread for the lifetime of the scope, the scopes nest
+    class resource_scope
+    {
+    public:
+        explicit resource_scope(std::pmr::memory_resource* resource)
+            : m_prev(current_ref())
         {
-            initial,
-            got_n,
-            got_u,
-            got_l,
-            done,
-            failure,
-        };
+            current_ref() = resource;
+        }
 
-        enum class e_null_events
+        resource_scope(const resource_scope&) = delete;
+        resource_scope& operator=(const resource_scope&) = delete;
+
+        ~resource_scope() { current_ref() = m_prev; }
+
+        /// The resource of the innermost scope on the calling thread, std::pmr::get_default_resource() if there is none
+        static std::pmr::memory_resource* current()
         {
-            // ascii part
-            letter_n,   // n
-            letter_u,   // u
-            letter_l,   // l
-            other,
-        };
+            std::pmr::memory_resource* const resource = current_ref();
+            return nullptr != resource ? resource : std::pmr::get_default_resource();
+        }
 
-        class null_parser_t
-            : public parser_impl<null_t, e_null_events, e_null_states, e_null_states::initial>
+    protected:
+        static std::pmr::memory_resource*& current_ref()
         {
-            using event_t = e_null_events;
-            using state_t = e_null_states;
-            using EventToStateTable_t = StateTable<state_t, event_t>;
+            static thread_local std::pmr::memory_resource* resource = nullptr;
+            return resource;
+        }
 
-        public:
-            null_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial, { { event_t::letter_n, { state_t::got_n,   STD_BIND_TO_THIS(null_parser_t, on_n    ) } },
-                                      { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-                { state_t::got_n,   { { event_t::letter_u, { state_t::got_u,   STD_BIND_TO_THIS(null_parser_t, on_u    ) } },
-                                      { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-                { state_t::got_u,   { { event_t::letter_l, { state_t::got_l,   STD_BIND_TO_THIS(null_parser_t, on_l    ) } },
-                                      { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-                { state_t::got_l,   { { event_t::letter_l, { state_t::done,    STD_BIND_TO_THIS(null_parser_t, on_done ) } },
-                                      { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-                { state_t::done,    { { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-                { state_t::failure, { { event_t::other,    { state_t::failure, STD_BIND_TO_THIS(null_parser_t, on_fail ) } },
-                } },
-            }
-            {};
+        std::pmr::memory_resource* const m_prev;
+    };
 
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
+    /// std::pmr::polymorphic_allocator for the json_t AllocatorT parameter(see pmr_json). Every container carries its
+    /// memory_resource and passes it to the nested containers and strings by the uses-allocator construction: an
+    /// element copied or moved into the container ends up in the container's resource, the whole tree stays in one.
+    /// json_t creates its containers with the default constructed allocators, those take the resource of the current
+    /// resource_scope, so the parsers build the tree in it. A copied container goes to the current resource as well
+    /// (the receiving module's one), the moved container keeps its own.
+    template <class T>
+    class resource_allocator
+        : public std::pmr::polymorphic_allocator<T>
+    {
+        using base_t = std::pmr::polymorphic_allocator<T>;
 
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
+    public:
+        resource_allocator() noexcept
+            : base_t(resource_scope::current())
+        {
+        }
 
-            virtual value get() const final;
+        resource_allocator(std::pmr::memory_resource* resource) noexcept
+            : base_t(resource)
+        {
+        }
 
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+        resource_allocator(const resource_allocator& other) noexcept = default;
 
-            virtual event_t to_event(const symbol_t& c) const override;
+        /// The uses-allocator construction of the nested containers hands the polymorphic_allocator down
+        template <class U>
+        resource_allocator(const std::pmr::polymorphic_allocator<U>& other) noexcept
+            : base_t(other.resource())
+        {
+        }
 
-            virtual event_t to_event(const result_t& c) const override;
+        resource_allocator select_on_container_copy_construction() const { return resource_allocator(); }
+    };
+    #pragma endregion
+#endif
+    //////////////////////////////////////////////////////////////////////////
+    template <
+        class SymbolT           = char,
+        class IntegerT          = int64_t,
+        class FloatingPtT       = double,
+        class BooleanT          = bool,
+        class NullT             = nullptr_t,
+        template <class _Kty, class _Ty>
+            class PairT         = std::pair,
+        template <class _Ty>
+            class LessT         = std::less,
+        template <class _Elem>
+            class CharTraitsT   = std::char_traits,
+        template <class _Ty, class _Alloc> 
+            class VectorT       = std::vector, 
+        template <class _Ty, class _Alloc>
+            class ListT         = std::list,
+        template <class _Kty, class _Ty, class _Pr, class _Alloc>
+            class MapT          = std::map,
+        template <class _Elem, class _Traits, class _Alloc>
+            class StringT       = std::basic_string,
+        template <class _Elem, class _Traits, class _Alloc>
+            class StrStrmT      = std::basic_stringstream,
+        template <class _Elem, class _Traits>
+            class IStrmT        = std::basic_istream,
+        template <class _Ty>
+            class AllocatorT    = std::allocator
+    >
+    class json_t
+    {
+    public:
+        using symbol_t          = SymbolT;
+        using integer_t         = IntegerT;
+        using floatingpt_t      = FloatingPtT;
+        using boolean_t         = BooleanT;
+        using null_t            = NullT;
 
-            // Own methods
-            result_t on_n(const symbol_t& c, const int pos);
+        /// The symbol offset in the input, 64 bit whatever the platform to address the inputs over 2 GB
+        using pos_t             = int64_t;
+
+        template <class _Ty> 
+            using allocator_t   = AllocatorT<_Ty>;
+        template <class _Kty, class _Ty> 
+            using pair_t        = PairT<_Kty, _Ty>;
+        template <class _Elem>
+            using char_traits_t = CharTraitsT<_Elem>;
+        template <class _Ty>
+            using less_t        = LessT<_Ty>;
+        template <class _Ty, class _Alloc = allocator_t<_Ty>> 
+            using vector_t      = VectorT<_Ty, _Alloc>;
+        template <class _Ty, class _Alloc = allocator_t<_Ty>> 
+            using list_t        = ListT<_Ty, _Alloc>;
+        template <class _Kty, class _Ty, class _Pr = less_t<_Kty>, class _Alloc = allocator_t<pair_t<const _Kty, _Ty>>> 
+            using map_t         = MapT<_Kty, _Ty, _Pr, _Alloc>;
+        template <class _Elem, class _Traits = char_traits_t<_Elem>, class _Alloc = allocator_t<_Elem>> 
+            using string_t      = StringT<_Elem, _Traits, _Alloc>;
+            using string = string_t<symbol_t>;
+        template <class _Elem, class _Traits = char_traits_t<_Elem>, class _Alloc = allocator_t<_Elem>>
+            using sstream_t     = StrStrmT<_Elem, _Traits, _Alloc>;
+            using sstream = sstream_t<symbol_t>;
+        template <class _Elem, class _Traits = char_traits_t<_Elem>>
+            using istream_t     = IStrmT<_Elem, _Traits>;
+            using istream = istream_t<symbol_t>;
+        template <class _Elem, class _Traits = char_traits_t<_Elem>>
+#if _HAS_CXX17
+            using string_view_t = std::basic_string_view<_Elem, _Traits>;
+#else
+            using string_view_t = boost::basic_string_view<_Elem, _Traits>;
+#endif
+            using string_view = string_view_t<symbol_t>;
 
-            result_t on_u(const symbol_t& c, const int pos);
+        /// Forward declaration for JSON object data structure
+        class obj;
 
-            result_t on_l(const symbol_t& c, const int pos);
+        /// Forward declaration for JSON array data structure
+        class arr;
 
-            result_t on_done(const symbol_t& c, const int pos);
+        /// Forward declaration for JSON value data structure
+        class value;
 
-            result_t on_fail(const symbol_t& c, const int pos);
+        /// Forward declaration for the parser interface
+        class parser;
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
-        };
-    #pragma endregion
-    //
-    #pragma region -- bool parser declaration -- 
-        enum class e_bool_states
+        /// possible results
+        enum class result_t
         {
-            initial,
-            got_t,
-            got_r,
-            got_u,
-            got_f,
-            got_a,
-            got_l,
-            got_s,
-            done,
-            failure,
+            s_need_more     =  3, // Need more data.
+            s_done_rpt      =  2, // Symbol successfully terminates parsing but makes no sense to current parser. Reparse symbol by above parser.
+            s_done          =  1, // Symbol successfully terminates parsing and makes sense to current parser.
+            s_ok            =  0, // General success.
+            e_fatal         = -1, // General failure.
+            e_unexpected    = -2, // Unexpected parameter or value.
+            e_depth_limit   = -3, // The nesting depth exceeds the limit.
         };
 
-        enum class e_bool_events
+        /// Parser engines
+        enum class engine_t
         {
-            letter_a,
-            letter_e,
-            letter_f,
-            letter_l,
-            letter_r,
-            letter_s,
-            letter_t,
-            letter_u,
-            symbol,
+            automaton,      // The composition of per token state machines fed symbol by symbol(resumable, see session).
+            structural,     // Two stage: the structural index of the whole buffer, then the tree construction over the index.
+            flat,           // Single grammar automaton with an explicit container stack, no recursion whatever the depth.
         };
 
-        class bool_parser_t
-            : public parser_impl<boolean_t, e_bool_events, e_bool_states, e_bool_states::initial>
+        /// Parsing options
+        struct options
         {
-            using event_t = e_bool_events;
-            using state_t = e_bool_states;
-            using EventToStateTable_t = StateTable<state_t, event_t>;
-        public:
-            bool_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial, { { event_t::letter_t, { state_t::got_t,   STD_BIND_TO_THIS( bool_parser_t, on_t    ) } },
-                                      { event_t::letter_f, { state_t::got_f,   STD_BIND_TO_THIS( bool_parser_t, on_f    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_t,   { { event_t::letter_r, { state_t::got_r,   STD_BIND_TO_THIS( bool_parser_t, on_r    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_r,   { { event_t::letter_u, { state_t::got_u,   STD_BIND_TO_THIS( bool_parser_t, on_u    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_u,   { { event_t::letter_e, { state_t::done,    STD_BIND_TO_THIS( bool_parser_t, on_done ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_f,   { { event_t::letter_a, { state_t::got_a,   STD_BIND_TO_THIS( bool_parser_t, on_a    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_a,   { { event_t::letter_l, { state_t::got_l,   STD_BIND_TO_THIS( bool_parser_t, on_l    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_l,   { { event_t::letter_s, { state_t::got_s,   STD_BIND_TO_THIS( bool_parser_t, on_s    ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::got_s,   { { event_t::letter_e, { state_t::done,    STD_BIND_TO_THIS( bool_parser_t, on_done ) } },
-                                      { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::done,    { { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-                { state_t::failure, { { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( bool_parser_t, on_fail ) } },
-                } },
-            } {};
-
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
-
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
-
-            virtual value get() const final;
+            engine_t engine = engine_t::automaton;
+            size_t max_depth = 0;   // The nesting depth limit of the flat engine, 0 - no limit.
+        };
 
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+        inline static boolean_t failed(const result_t& r) { return r < result_t::s_ok; }
+        inline static boolean_t succeded(const result_t& r) { return r >= result_t::s_ok; }
 
-            virtual event_t to_event(const symbol_t& c) const override;
+        /// JSON insignificant whitespace - space, tab, cr, lf
+        inline static boolean_t is_space(const symbol_t& c) { return (0x20 == c || 0x09 == c || 0x0A == c || 0x0D == c); }
 
-            virtual event_t to_event(const result_t& c) const override;
+        static result_t parse(istream& input, obj& jsobj)
+        {
+            symbol_t c = 0;
+            result_t result = result_t::s_ok;
 
-            // Own methods
-            result_t on_t(const symbol_t& c, const int pos);
+            typename parser::ptr p = create();
+            if (!p)
+                return result_t::e_fatal;
 
-            result_t on_r(const symbol_t& c, const int pos);
+            while (input >> std::noskipws >> c || result != result_t::s_done)
+            {
+                result = p->putchar(c, (pos_t)input.tellg() - 1);
 
-            result_t on_u(const symbol_t& c, const int pos);
+                if (result_t::s_ok > result)
+                    break;
 
-            result_t on_f(const symbol_t& c, const int pos);
+                if (result_t::s_done == result)
+                {
+                    jsobj = p->take().take<obj>();
+                    break;
+                }
+            }
 
-            result_t on_a(const symbol_t& c, const int pos);
+            return result;
+        }
 
-            result_t on_l(const symbol_t& c, const int pos);
+        /// Parses the JSON text of any root type(object, array or scalar) from the contiguous buffer [begin, begin + len).
+        /// The buffer is walked by pointer, no intermediate stream or copy is made.
+        static result_t parse(const symbol_t* begin, const size_t len, value& jsval)
+        {
+            return parse(begin, len, jsval, options());
+        }
 
-            result_t on_s(const symbol_t& c, const int pos);
+        static result_t parse(const symbol_t* begin, const size_t len, value& jsval, const options& opts)
+        {
+            if (engine_t::structural == opts.engine && 1 == sizeof(symbol_t))
+            {
+                structural_parser_t p;
+                return p.parse(begin, len, jsval);
+            }
 
-            result_t on_done(const symbol_t& c, const int pos);
+            if (engine_t::flat == opts.engine)
+            {
+                dom_builder_t builder(jsval);
+                flat_parser_t<dom_builder_t> p(builder, opts.max_depth);
+                return p.parse(begin, len);
+            }
 
-            result_t on_fail(const symbol_t& c, const int pos);
+            session s(create_value());
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
+            const result_t result = s.parse(begin, len);
+            if (result_t::s_done == result)
+                jsval = s.take();
 
-            string m_str;
-        };
-    #pragma endregion 
-    //
-    #pragma region -- value parser declaration -- 
-        enum class e_value_states
-        {
-            initial,
-            read,
-            done,
-            failure,
-        };
+            return result;
+        }
 
-        enum class e_value_events
+        /// Parses the JSON object from the contiguous buffer [begin, begin + len).
+        static result_t parse(const symbol_t* begin, const size_t len, obj& jsobj)
         {
-            symbol = 0xffff,
-            val_done,
-            nothing,
-        };
+            return parse(begin, len, jsobj, options());
+        }
 
-        class value_parser_t
-            : public parser_impl<nullptr_t, e_value_events, e_value_states, e_value_states::initial>
+        static result_t parse(const symbol_t* begin, const size_t len, obj& jsobj, const options& opts)
         {
-            using event_t               = e_value_events;
-            using state_t               = e_value_states;
-            using EventToStateTable_t   = StateTable<state_t, event_t>;
-            using ParserItem_t          = pair_t<typename boolean_t, typename parser::ptr>;
-        public:
-            value_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial, { { event_t::symbol,   { state_t::read,    STD_BIND_TO_THIS( value_parser_t, on_data ) } },
-                } },
-                { state_t::read,    { { event_t::symbol,   { state_t::read,    STD_BIND_TO_THIS( value_parser_t, on_data ) } },
-                                      { event_t::val_done, { state_t::done,    STD_BIND_TO_THIS( value_parser_t, on_done ) } },
-                } },
-                { state_t::done,    { { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( value_parser_t, on_fail ) } },
-                } },
-                { state_t::failure, { { event_t::symbol,   { state_t::failure, STD_BIND_TO_THIS( value_parser_t, on_fail ) } },
-                } },
-            } {};
-
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
-
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
-
-            virtual value get() const final;
-
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+            if (engine_t::flat == opts.engine || (engine_t::structural == opts.engine && 1 == sizeof(symbol_t)))
+            {
+                value jsval;
 
-            virtual event_t to_event(const symbol_t& c) const override;
+                const result_t result = parse(begin, len, jsval, opts);
+                if (result_t::s_done != result)
+                    return result;
 
-            virtual event_t to_event(const result_t& c) const override;
+                if (!jsval.is_object())
+                    return result_t::e_unexpected;
 
-            // Own methods
-            result_t on_data(const symbol_t& c, const int pos);
+                jsobj = jsval.take<obj>();
+                return result;
+            }
 
-            result_t on_done(const symbol_t& c, const int pos);
+            session s(create());
 
-            result_t on_fail(const symbol_t& c, const int pos);
+            const result_t result = s.parse(begin, len);
+            if (result_t::s_done == result)
+                jsobj = s.take().take<obj>();
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
+            return result;
+        }
 
-            std::list<ParserItem_t> parsing_unit;
-        };
-    #pragma endregion
-    //
-    #pragma region -- array parser declaration -- 
-        enum class e_array_states
+        static result_t parse(const string& input, value& jsval)
         {
-            initial,    //
-            val_before, //
-            val_inside, //
-            val_after,  //
-            done,       //
-            failure,    //
-        };
+            return parse(input.data(), input.size(), jsval);
+        }
 
-        enum class e_array_events
+        static result_t parse(const string& input, obj& jsobj)
         {
-            arr_begin,  // [
-            arr_end,    // ]
-            val_done,   //
-            val_error,  //
-            comma,      // ,
-            symbol,     // any symbol(depends on state)
-            skip,       // space, tab, cr, lf
-            nothing,    // no action event
-        };
+            return parse(input.data(), input.size(), jsobj);
+        }
 
-        class array_parser_t
-            : public parser_impl<arr, e_array_events, e_array_states, e_array_states::initial>
+        static result_t parse(const string& input, value& jsval, const options& opts)
         {
-            using event_t = e_array_events;
-            using state_t = e_array_states;
-            using EventToStateTable_t = StateTable<state_t, event_t>;
-
-        public:
-            array_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial,    { { event_t::arr_begin, { state_t::val_before,  STD_BIND_TO_THIS( array_parser_t, on_begin   ) } },
-                                         { event_t::skip,      { state_t::val_before,  STD_BIND_TO_THIS( array_parser_t, on_more    ) } },
-                                         { event_t::symbol,    { state_t::failure,     STD_BIND_TO_THIS( array_parser_t, on_fail    ) } },
-                } },
-                { state_t::val_before, { { event_t::symbol,    { state_t::val_inside,  STD_BIND_TO_THIS( array_parser_t, on_val     ) } },
-                                         { event_t::skip,      { state_t::val_before,  STD_BIND_TO_THIS( array_parser_t, on_more    ) } },
-                                         { event_t::arr_end,   { state_t::done,        STD_BIND_TO_THIS( array_parser_t, on_done    ) } },
-                } },
-                { state_t::val_after,  { { event_t::arr_end,   { state_t::done,        STD_BIND_TO_THIS( array_parser_t, on_done    ) } },
-                                         { event_t::comma,     { state_t::val_before,  STD_BIND_TO_THIS( array_parser_t, on_new     ) } },
-                                         { event_t::skip,      { state_t::val_before,  STD_BIND_TO_THIS( array_parser_t, on_more    ) } },
-                                         { event_t::symbol,    { state_t::failure,     STD_BIND_TO_THIS( array_parser_t, on_fail    ) } },
-                } },
-                { state_t::val_inside, { { event_t::symbol,    { state_t::val_inside,  STD_BIND_TO_THIS( array_parser_t, on_val     ) } },
-                                         { event_t::val_done,  { state_t::val_after,   STD_BIND_TO_THIS( array_parser_t, on_got_val ) } },
-                                         { event_t::val_error, { state_t::failure,     STD_BIND_TO_THIS( array_parser_t, on_fail    ) } },
-                } },
-                { state_t::done,       { { event_t::symbol,    { state_t::failure,     STD_BIND_TO_THIS( array_parser_t, on_fail    ) } },
-                } },
-                { state_t::failure,    { { event_t::symbol,    { state_t::failure,     STD_BIND_TO_THIS( array_parser_t, on_fail    ) } },
-                } },
-            } {};
-
-        protected:
-            // Inherited via parser
-            virtual void reset() final;
-
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
-
-            virtual value get() const final;
-
-            // Inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
-
-            virtual event_t to_event(const symbol_t& c) const override;
+            return parse(input.data(), input.size(), jsval, opts);
+        }
 
-            virtual event_t to_event(const result_t& r) const override;
+        static result_t parse(const string& input, obj& jsobj, const options& opts)
+        {
+            return parse(input.data(), input.size(), jsobj, opts);
+        }
 
-            // Own methods
-            result_t on_more(const unsigned& c, const int pos);
+#if _HAS_CXX17
+        static result_t parse(const string_view& input, value& jsval)
+        {
+            return parse(input.data(), input.size(), jsval);
+        }
 
-            result_t on_begin(const symbol_t& c, const int pos);
+        static result_t parse(const string_view& input, obj& jsobj)
+        {
+            return parse(input.data(), input.size(), jsobj);
+        }
+#endif
 
-            result_t on_new(const symbol_t& c, const int pos);
+        /// Parses the newline delimited JSON buffer [data, data + len) on the pool of threads(0 - one per core).
+        /// The buffer is split into line aligned chunks, every thread has its own parser. The documents go to the
+        /// callback in the input order, on the calling thread. Blank lines are skipped. Returns s_done or the error of
+        /// the first broken line, the documents before it are delivered. At most 2 chunks a thread are parsed ahead of
+        /// the delivery. An exception of the callback or of a parsing thread stops the threads and goes to the caller.
+        static result_t parse_ndjson(const symbol_t* data, const size_t len, const std::function<void(value&&)>& on_document,
+                                     const size_t threads = 0);
 
-            result_t on_val(const symbol_t& c, const int pos);
+        /// Parses the newline delimited JSON buffer [data, data + len) on the pool of threads(0 - one per core) to the
+        /// documents in the input order(see the above)
+        static result_t parse_ndjson(const symbol_t* data, const size_t len, vector_t<value>& documents, const size_t threads = 0);
 
-            result_t on_got_val(const symbol_t& c, const int pos);
+        /// Parses the single JSON document [data, data + len) on the pool of threads(0 - one per core). The members of
+        /// the root array or object are split by a structural prescan into chunks parsed concurrently, then moved to the
+        /// root in order. Other roots and small documents are parsed by the flat engine on the calling thread.
+        static result_t parse_parallel(const symbol_t* data, const size_t len, value& jsval, const size_t threads = 0);
 
-            result_t on_done(const symbol_t& c, const int pos);
+    #pragma region -- value definition --
+        class value
+#if _HAS_CXX17
+            : public std::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>
+#else
+            : public boost::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>
+#endif
+        {
+#if _HAS_CXX17
+            using base_t = std::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>;
+#else
+            using base_t = boost::variant<string, obj, arr, integer_t, floatingpt_t, boolean_t, null_t>;
+#endif
+        public:
+            /// The enumeration for mnemonic correlation of indeces and types used for std::variant
+            enum class vt
+            {   /// IMPORTANT: The order of parameters is the same as value_t template parameters order
+                t_string     = 0,
+                t_object     = 1,
+                t_array      = 2,
+                t_integer    = 3,
+                t_floatingpt = 4,
+                t_boolean    = 5,
+                t_null       = 6,
+            };
+
+            static inline bool check_vt_val(const vt& v) { return (vt::t_string <= v || v <= vt::t_null); }
+
+            /// {ctor}s
+            value() { }
+            value(const string& other)      : base_t(other)         {}
+            value(const obj& other)         : base_t(other)         {}
+            value(const arr&  other)        : base_t(other)         {}
+            value(const integer_t   other)  : base_t(other)         {}
+            value(const floatingpt_t other) : base_t(other)         {}
+            value(const boolean_t other)    : base_t(other)         {}
+            value(const symbol_t* other)    : base_t(string(other)) {}
+            value(const null_t other)       : base_t(other)         {}
+            value(string&& other)           : base_t(std::move(other)) {}
+            value(obj&& other)              : base_t(std::move(other)) {}
+            value(arr&& other)              : base_t(std::move(other)) {}
+
+#if _HAS_CXX17
+            /// The allocator the string, object and array alternatives are given by the uses-allocator construction
+            using allocator_type = allocator_t<value>;
+
+            /// allocator extended {ctor}s
+            value(std::allocator_arg_t, const allocator_type& a)
+                : base_t(std::in_place_type<string>, typename string::allocator_type(a)) {}
+            value(std::allocator_arg_t, const allocator_type& a, const value& other)
+                : base_t(with_allocator(other, a)) {}
+            value(std::allocator_arg_t, const allocator_type& a, value&& other)
+                : base_t(with_allocator(std::move(other), a)) {}
+
+            value(const value& other) = default;
+            value(value&& other) = default;
+            value& operator=(const value& other) = default;
+            value& operator=(value&& other) = default;
+#endif
+
+#if _HAS_CXX17
+            vt index() const {
+                return (vt)base_t::index();
+            }
+            template <class T>
+            T get(T* t = nullptr) const {
+                return std::get<T>(*this);
+            }
+            /// Moves the content out, the value keeps the moved-from one
+            template <class T>
+            T take() {
+                return std::move(std::get<T>(*this));
+            }
+#else            
+            vt index() const {
+                return (vt)base_t::which();
+            }
+            template <class T>
+            T get(T* t = nullptr) const {
+                return boost::get<T>(*this);
+            }
+            /// Moves the content out, the value keeps the moved-from one
+            template <class T>
+            T take() {
+                return std::move(boost::get<T>(*this));
+            }
+#endif
+
+            /// Assign operators
+            const value& operator=(const string& other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(const obj& other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(const arr& other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(string&& other)
+            {
+                base_t::operator=(std::move(other));
+                return (*this);
+            }
+
+            const value& operator=(obj&& other)
+            {
+                base_t::operator=(std::move(other));
+                return (*this);
+            }
+
+            const value& operator=(arr&& other)
+            {
+                base_t::operator=(std::move(other));
+                return (*this);
+            }
+
+            const value& operator=(const integer_t other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(const floatingpt_t other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(const boolean_t other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            const value& operator=(const symbol_t* other)
+            {
+                base_t::operator=(string(other));
+                return (*this);
+            }
+
+            const value& operator=(const null_t other)
+            {
+                base_t::operator=(other);
+                return (*this);
+            }
+
+            inline bool is_string()     const { return vt::t_string     == index(); }
+            inline bool is_object()     const { return vt::t_object     == index(); }
+            inline bool is_array()      const { return vt::t_array      == index(); }
+            inline bool is_integer()    const { return vt::t_integer    == index(); }
+            inline bool is_floatingpt() const { return vt::t_floatingpt == index(); }
+            inline bool is_number()     const { return is_integer() || is_floatingpt(); };
+            inline bool is_boolean()    const { return vt::t_boolean    == index(); }
+            inline bool is_null()       const { return vt::t_null       == index(); }
+
+            operator obj() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_object)
+                    throw std::logic_error("Not an object.");
+
+                return get<obj>();
+            }
+
+            operator arr() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_array)
+                    throw std::logic_error("Not an array.");
+
+                return get<arr>();
+            }
+
+            explicit operator string() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_string)
+                    throw std::logic_error("Not a string.");
+
+                return get<string>();
+            }
+
+            explicit operator int64_t() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_integer)
+                    throw std::logic_error("Not an integer number.");
+
+                return (int64_t)get<integer_t>();
+            }
+
+            explicit operator floatingpt_t() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_floatingpt)
+                    throw std::logic_error("Not a floating pointer number.");
+
+                return get<floatingpt_t>();
+            }
+
+            explicit operator boolean_t() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_boolean)
+                    throw std::logic_error("Not a boolean.");
+
+                return get<boolean_t>();
+            }
+
+            explicit operator null_t() const
+            {
+                assert(check_vt_val(index()));
+
+                if (index() != vt::t_null)
+                    throw std::logic_error("Not a null.");
+
+                return get<null_t>();
+            }
+
+            value operator[](const string& key) 
+            {
+                return operator obj()[key];
+            }
+
+            value operator[](const size_t& idx) 
+            {
+                return operator arr()[idx];
+            }
+
+            explicit operator int32_t() const
+            {
+                return (int32_t)(operator int64_t());
+            }
+
+            explicit operator int16_t() const
+            {
+                return (int16_t)(operator int64_t());
+            }
+
+#if _HAS_CXX17
+        protected:
+            /// The copy of the alternative made by the allocator
+            static base_t with_allocator(const value& other, const allocator_type& a)
+            {
+                switch (other.index())
+                {
+                case vt::t_string:  return base_t(std::in_place_type<string>, std::get<string>(other), typename string::allocator_type(a));
+                case vt::t_object:  return base_t(std::in_place_type<obj>, std::get<obj>(other), typename obj::allocator_type(a));
+                case vt::t_array:   return base_t(std::in_place_type<arr>, std::get<arr>(other), typename arr::allocator_type(a));
+                default:            return static_cast<const base_t&>(other);
+                }
+            }
+
+            /// The alternative moved by the allocator, copied if the allocators differ
+            static base_t with_allocator(value&& other, const allocator_type& a)
+            {
+                switch (other.index())
+                {
+                case vt::t_string:  return base_t(std::in_place_type<string>, std::move(std::get<string>(other)), typename string::allocator_type(a));
+                case vt::t_object:  return base_t(std::in_place_type<obj>, std::move(std::get<obj>(other)), typename obj::allocator_type(a));
+                case vt::t_array:   return base_t(std::in_place_type<arr>, std::move(std::get<arr>(other)), typename arr::allocator_type(a));
+                default:            return static_cast<base_t&&>(other);
+                }
+            }
+#endif
+        };
+
+    #pragma endregion
+    //
+    #pragma region -- json data declaration --
+        template<class BaseType>
+        class container
+            : public BaseType
+        {
+        public:
+            using my_base_t = BaseType;
+
+            using allocator_type = typename BaseType::allocator_type;
+
+            /// {ctor}s
+            container() = default;
+            container(std::initializer_list<value> l) : BaseType(l) {}
+            container(const container& other) = default;
+            container(container&& other) = default;
+
+            /// allocator extended {ctor}s
+            explicit container(const allocator_type& a) : BaseType(a) {}
+            container(const container& other, const allocator_type& a) : BaseType(other, a) {}
+            container(container&& other, const allocator_type& a) : BaseType(std::move(other), a) {}
+
+            container& operator=(const container& other) = default;
+            container& operator=(container&& other) = default;
+
+            virtual const string str(sstream& str = stream()) const = 0;
+
+            protected:
+                string serialize_string(const string& s) const
+                {
+                    string r;
+
+                    for (symbol_t c : s)
+                    {
+                        switch (c)
+                        {
+                        case '\b':          // backspace
+                            r += "\\b";
+                            break;
+                        case '\f':          // form feed
+                            r += "\\f";
+                            break;
+                        case '\n':          // new line
+                            r += "\\n";
+                            break;
+                        case '\r':          // carriage return
+                            r += "\\r";
+                            break;
+                        case '\t':          // horizontal tab
+                            r += "\\t";
+                            break;
+                        case '\\':          // back slash
+                            r += "\\\\";
+                            break;
+                        case '/':           // forward slash
+                            r += "\\/";
+                            break;
+                        // TODO: needed to properly serialize unicode(2-byte) symbols
+                        default:
+                            r.push_back(c); // all other
+                            break;
+                        }
+                    }
+
+                    return r;
+                }
+        };
+
+        /// Declaration of the object JSON data structure
+        class obj 
+            : public container<map_t<string, value>>
+        {
+        public:
+            // constant iterator type 
+            typedef typename container<map_t<string, value>>::my_base_t::const_iterator cit;
+
+            // iterator type
+            typedef typename container<map_t<string, value>>::my_base_t::iterator it;
+
+            // default constructor
+            obj() = default;
+
+            // initializers list constructor
+            obj(std::initializer_list<pair_t<string, value>> l);
+
+            // allocator extended constructors
+            explicit obj(const typename container<map_t<string, value>>::allocator_type& a)
+                : container<map_t<string, value>>(a) {}
+            obj(const obj& other, const typename container<map_t<string, value>>::allocator_type& a)
+                : container<map_t<string, value>>(other, a) {}
+            obj(obj&& other, const typename container<map_t<string, value>>::allocator_type& a)
+                : container<map_t<string, value>>(std::move(other), a) {}
+
+            obj(const obj& other) = default;
+            obj(obj&& other) = default;
+            obj& operator=(const obj& other) = default;
+            obj& operator=(obj&& other) = default;
+
+            // random access operator 
+            value& operator[](const string& key)
+            {
+                return container::operator[](key);
+            }
+
+            // random access operator taking the key over
+            value& operator[](string&& key)
+            {
+                return container::operator[](std::move(key));
+            }
+
+            // constant random access operator
+            const value& operator[](const string& key) const
+            {
+                return container::at(key);
+            }
+
+            // certain key presence test
+            boolean_t exists(const string& key) const
+            {
+                return end() != find(key);
+            }
+
+            // convert to string
+            operator string() const
+            {
+                return str();
+            }
+
+            /// serialization
+            virtual const string str(sstream& str = sstream()) const final;
+        };
+
+        /// Declaration of the array JSON data structure
+        class arr 
+            : public container<vector_t<value>>
+        {
+        public:
+            // constant iterator type
+            typedef typename container<vector_t<value>>::my_base_t::const_iterator cit;
+
+            // iterator
+            typedef typename container<vector_t<value>>::my_base_t::iterator it;
+
+            // default constructor type
+            arr() = default;
+
+            // initializer list constructor
+            arr(std::initializer_list<value> l);
+
+            // allocator extended constructors
+            explicit arr(const typename container<vector_t<value>>::allocator_type& a)
+                : container<vector_t<value>>(a) {}
+            arr(const arr& other, const typename container<vector_t<value>>::allocator_type& a)
+                : container<vector_t<value>>(other, a) {}
+            arr(arr&& other, const typename container<vector_t<value>>::allocator_type& a)
+                : container<vector_t<value>>(std::move(other), a) {}
+
+            arr(const arr& other) = default;
+            arr(arr&& other) = default;
+            arr& operator=(const arr& other) = default;
+            arr& operator=(arr&& other) = default;
+
+            // convert to string
+            operator string() const
+            {
+                return str();
+            }
+
+            // serialization
+            virtual const string str(sstream& str = sstream()) const final;
+        };
+    #pragma endregion
+    //
+    #pragma region -- parser interface --
+        /// Common parser interface
+        class parser
+        {
+        public:
+            typedef std::shared_ptr<parser> ptr;
+
+            virtual ~parser() {};
+
+            /// Drops the internal state to initial(i.e. as just constructed)
+            virtual void        reset() = 0;
+
+            /// Puts a character to the parsing routine
+            virtual result_t    putchar(const symbol_t& c, const pos_t pos) = 0;
+
+            /// Puts the leading run of the data that leaves the parser state as is(i.e. the plain symbols of a string) at once.
+            /// Returns the length of the run taken, 0 - the next symbol must go through putchar().
+            virtual size_t      putrun(const symbol_t* data, const size_t len, const pos_t pos) { return 0; }
+
+            /// Retrieves the parsing result
+            virtual value       get() const = 0;
+
+            /// Moves the parsing result out, no copy of the subtree is made. The parser must be reset after that.
+            virtual value       take() { return get(); }
+        };
+    #pragma endregion
+    //
+    #pragma region -- parser_base -- 
+    #pragma region -- state machine types --
+        /// The transition: the state to move to and the handler of the owner parser to call
+        template<typename OWNER, typename STATE>
+        struct Transition
+        {
+            using handler_t = result_t (OWNER::*)(const symbol_t&, const pos_t);
+
+            STATE       next    = STATE();
+            handler_t   handler = nullptr;
+        };
+
+        /// The event row of the declarative table: event -> transition
+        template<typename OWNER, typename STATE, typename EVENT>
+        struct EventRow
+        {
+            EVENT                       event;
+            Transition<OWNER, STATE>    transition;
+        };
+
+        /// The state row of the declarative table: state -> event rows
+        template<typename OWNER, typename STATE, typename EVENT>
+        struct StateRow
+        {
+            STATE                                                   state;
+            std::initializer_list<EventRow<OWNER, STATE, EVENT>>    events;
+        };
+
+        /// Dense transition table indexed by [state][event]. Built at compile time from the declarative
+        /// { state, { { event, { next state, handler } }, ... } } rows and shared by all parsers of the owner type.
+        template<typename OWNER, typename STATE, typename EVENT>
+        class StateTable
+        {
+        public:
+            using transition_t = Transition<OWNER, STATE>;
+
+            constexpr StateTable(std::initializer_list<StateRow<OWNER, STATE, EVENT>> rows)
+                : m_cells()
+            {
+                for (const StateRow<OWNER, STATE, EVENT>& row : rows)
+                    for (const EventRow<OWNER, STATE, EVENT>& cell : row.events)
+                        m_cells[(size_t)row.state][(size_t)cell.event] = cell.transition;
+            }
+
+            constexpr const transition_t& at(const STATE s, const EVENT e) const
+            {
+                return m_cells[(size_t)s][(size_t)e];
+            }
+
+        private:
+            transition_t m_cells[(size_t)STATE::count][(size_t)EVENT::count];
+        };
+    #pragma endregion
+        template<typename STATE, STATE initial_state>
+        class state
+        {
+        private:
+            STATE m_state = initial_state;
+
+        protected:
+            STATE get() const { return m_state; };
+            void set(STATE new_state) { m_state = new_state; }
+        };
+
+        template<class OwnerT, class ValueT, class EventsT, class StateT, StateT initial_state>
+        class parser_impl
+            : protected state<StateT, initial_state>
+            , public parser
+        {
+        public:
+            using event_t = EventsT;
+
+            parser_impl() {};
+
+            // The step of the automata: one indexed load from the shared table of the owner and one call
+            result_t step(const event_t& e, const symbol_t& c, const pos_t pos)
+            {
+                const auto& transition = OwnerT::table().at(state::get(), e);
+                if (!transition.handler)
+                    return result_t::e_unexpected;
+
+                const result_t res = (static_cast<OwnerT*>(this)->*transition.handler)(c, pos);
+
+                state::set(transition.next);
+
+                return res;
+            }
+
+        protected:
+            virtual event_t to_event(const symbol_t& c) const = 0;
+            virtual event_t to_event(const result_t& c) const = 0;
+
+            template <class V>
+            class optional
+                : public
+#if _HAS_CXX17
+                std::optional<V>
+#else
+                boost::optional<V>
+#endif
+            {
+            public:
+                operator bool() const
+                {
+#if _HAS_CXX17
+                    return has_value();
+#else
+                    return is_initialized();
+#endif
+                }
+            };
+            
+            optional<ValueT> m_value;
+        };
+    #pragma endregion
+    //////////////////////////////////////////////////////////////////////////
+    #pragma region -- string parser declaration -- 
+        enum class e_string_states
+        {
+            initial,    // wait for " and skipping space charscters - space, hrisontal tab, crlf, lf
+            inside,
+            escape,
+            unicode_1,
+            unicode_2,
+            unicode_3,
+            unicode_4,
+            done,
+            failure,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_string_events
+        {
+            symbol,
+            hex_digit,
+            quote,
+            back_slash,
+            slash,
+            alpha_b,    // stands for backspace
+            alpha_f,    // stands for form feed
+            alpha_n,    // stands for new line
+            alpha_r,    // stands for carriage return
+            alpha_t,    // stands for tab
+            alpha_u,    // stands for unicode
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class string_parser_t
+            : public parser_impl<string_parser_t, string, e_string_events, e_string_states, e_string_states::initial>
+        {
+        public:
+            using event_t               = e_string_events;
+            using state_t               = e_string_states;
+            using EventToStateTable_t   = StateTable<string_parser_t, state_t, event_t>;
+
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial,   { { event_t::quote,      { state_t::inside,    &string_parser_t::on_initial  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::inside,    { { event_t::quote,      { state_t::done,      &string_parser_t::on_done     } },
+                                            { event_t::back_slash, { state_t::escape,    &string_parser_t::on_escape   } },
+                                            { event_t::symbol,     { state_t::inside,    &string_parser_t::on_inside   } },
+                    } },
+                    { state_t::escape,    { { event_t::quote,      { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::back_slash, { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::slash,      { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_b,    { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_f,    { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_n,    { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_r,    { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_t,    { state_t::inside,    &string_parser_t::on_escape   } },
+                                            { event_t::alpha_u,    { state_t::unicode_1, &string_parser_t::on_unicode  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::unicode_1, { { event_t::hex_digit,  { state_t::unicode_2, &string_parser_t::on_unicode  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::unicode_2, { { event_t::hex_digit,  { state_t::unicode_3, &string_parser_t::on_unicode  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::unicode_3, { { event_t::hex_digit,  { state_t::unicode_4, &string_parser_t::on_unicode  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::unicode_4, { { event_t::hex_digit,  { state_t::inside,    &string_parser_t::on_unicode  } },
+                                            { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::done,      { { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                    { state_t::failure,   { { event_t::symbol,     { state_t::failure,   &string_parser_t::on_fail     } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual size_t putrun(const symbol_t* data, const size_t len, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            virtual value take() final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& c) const override;
+
+            // Own methods
+            result_t on_initial(const symbol_t&c, const pos_t pos);
+
+            result_t on_inside(const symbol_t&c, const pos_t pos);
+
+            result_t on_escape(const symbol_t&c, const pos_t pos);
+
+            result_t on_unicode(const symbol_t&c, const pos_t pos);
+
+            result_t on_done(const symbol_t&c, const pos_t pos);
+
+            result_t on_fail(const symbol_t&c, const pos_t pos);
+
+        protected:
+            string m_cache;
+
+            uint32_t m_surrogate      = 0; // the high surrogate of the last \uXXXX sequence
+            size_t   m_surrogate_end  = 0; // the length of the value right after the high surrogate was appended
+        };
+    #pragma endregion
+    //
+    #pragma region -- number parser declaration -- 
+        enum class e_number_states
+        {
+            initial,
+            leading_minus,
+            zero,
+            decimal_dot,
+            integer,
+            fractional,
+            exponent_delim,
+            exponent_sign,
+            exponent_val,
+            done,
+            failure,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_number_events
+        {
+            // ascii part
+            minus,      // -
+            plus,       // +
+            dec_zero,   // 0
+            dec_digit,  // 0x31 - 0x39
+            dot,        // .
+            exponent,   // E or 0x65 - e
+            symbol,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        /// The decimal number as it is written: value = significand(+ tail digits) * 10^(scale +/- exponent)
+        struct number
+        {
+            static constexpr int32_t max_digits     = 19;       // the digits always fitting uint64_t
+            static constexpr size_t  max_tail       = 768;      // the digits beyond that may affect the rounding
+            static constexpr int32_t max_exponent   = 100000;   // the exponent saturates here, far beyond double range
+
+            number()
+                : m_positive(true)
+                , m_is_float(false)
+                , m_significand(0)
+                , m_digits(0)
+                , m_scale(0)
+                , m_exponent_positive(true)
+                , m_exponent_value(0)
+            {}
+
+            boolean_t   m_positive;
+            boolean_t   m_is_float;             // has the fractional part or the exponent
+            uint64_t    m_significand;          // the leading significant digits
+            int32_t     m_digits;               // the number of significant digits in m_significand
+            int32_t     m_scale;                // the power of ten of the last digit of m_significand
+            boolean_t   m_exponent_positive;
+            int32_t     m_exponent_value;
+            std::string m_tail;                 // the significant digits beyond m_significand, only the long numbers have
+
+            void integer_digit(const uint32_t d);
+
+            void fractional_digit(const uint32_t d);
+
+            void exponent_digit(const uint32_t d);
+
+            /// Converts to the JSON value: integer if there is neither fraction nor exponent and it fits integer_t,
+            /// otherwise the correctly rounded floating point number
+            value to_value() const;
+
+        protected:
+            void tail_digit(const uint32_t d);
+
+            /// Correctly rounded conversion of any number by strtod
+            floatingpt_t to_floatingpt_slow(const int64_t exp10) const;
+        };
+
+        class number_parser_t
+            : public parser_impl<number_parser_t, number, e_number_events, e_number_states, e_number_states::initial>
+        {
+            using event_t = e_number_events;
+            using state_t = e_number_states;
+            using EventToStateTable_t = StateTable<number_parser_t, state_t, event_t>;
+        
+        public:
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial,        { { event_t::minus,     { state_t::leading_minus,  &number_parser_t::on_minus       } },
+                                                 { event_t::dec_zero,  { state_t::zero,           &number_parser_t::on_zero        } },
+                                                 { event_t::dec_digit, { state_t::integer,        &number_parser_t::on_integer     } },
+                                                 { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::leading_minus,  { { event_t::dec_zero,  { state_t::zero,           &number_parser_t::on_zero        } },
+                                                 { event_t::dec_digit, { state_t::integer,        &number_parser_t::on_integer     } },
+                                                 { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::zero,           { { event_t::dot,       { state_t::decimal_dot,    &number_parser_t::on_dot         } },
+                                                 { event_t::exponent,  { state_t::exponent_delim, &number_parser_t::on_exponent    } },
+                                                 { event_t::symbol,    { state_t::done,           &number_parser_t::on_done        } },
+                    } },
+                    { state_t::decimal_dot,    { { event_t::dec_zero,  { state_t::fractional,     &number_parser_t::on_fractional  } },
+                                                 { event_t::dec_digit, { state_t::fractional,     &number_parser_t::on_fractional  } },
+                                                 { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::integer,        { { event_t::dec_zero,  { state_t::integer,        &number_parser_t::on_integer     } },
+                                                 { event_t::dec_digit, { state_t::integer,        &number_parser_t::on_integer     } },
+                                                 { event_t::dot,       { state_t::decimal_dot,    &number_parser_t::on_dot         } },
+                                                 { event_t::exponent,  { state_t::exponent_delim, &number_parser_t::on_exponent    } },
+                                                 { event_t::symbol,    { state_t::done,           &number_parser_t::on_done        } },
+                    } },
+                    { state_t::fractional,     { { event_t::dec_zero,  { state_t::fractional,     &number_parser_t::on_fractional  } },
+                                                 { event_t::dec_digit, { state_t::fractional,     &number_parser_t::on_fractional  } },
+                                                 { event_t::exponent,  { state_t::exponent_delim, &number_parser_t::on_exponent    } },
+                                                 { event_t::symbol,    { state_t::done,           &number_parser_t::on_done        } },
+                    } },
+                    { state_t::exponent_delim, { { event_t::minus,     { state_t::exponent_sign,  &number_parser_t::on_exp_sign    } },
+                                                 { event_t::plus,      { state_t::exponent_sign,  &number_parser_t::on_exp_sign    } },
+                                                 { event_t::dec_zero,  { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::dec_digit, { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::exponent_sign,  { { event_t::dec_zero,  { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::dec_digit, { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::exponent_val,   { { event_t::dec_zero,  { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::dec_digit, { state_t::exponent_val,   &number_parser_t::on_exp_value   } },
+                                                 { event_t::symbol,    { state_t::done,           &number_parser_t::on_done        } },
+                    } },
+                    { state_t::done,           { { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                    { state_t::failure,        { { event_t::symbol,    { state_t::failure,        &number_parser_t::on_fail        } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            virtual value take() final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& c) const override;
+
+            // Own methods
+            result_t on_initial(const symbol_t& c, const pos_t pos);
+
+            result_t on_minus(const symbol_t& c, const pos_t pos);
+
+            result_t on_integer(const symbol_t& c, const pos_t pos);
+
+            result_t on_fractional(const symbol_t& c, const pos_t pos);
+
+            result_t on_exponent(const symbol_t& c, const pos_t pos);
+
+            result_t on_exp_sign(const symbol_t& c, const pos_t pos);
+
+            result_t on_exp_value(const symbol_t& c, const pos_t pos);
+
+
+            result_t on_zero(const symbol_t& c, const pos_t pos);
+
+            result_t on_dot(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+        protected:
+            value m_converted;  // the value converted once the number is complete
+        };
+    #pragma endregion
+    //
+    #pragma region -- null parser declaration -- 
+        enum class e_null_states
+        {
+            initial,
+            got_n,
+            got_u,
+            got_l,
+            done,
+            failure,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_null_events
+        {
+            // ascii part
+            letter_n,   // n
+            letter_u,   // u
+            letter_l,   // l
+            other,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class null_parser_t
+            : public parser_impl<null_parser_t, null_t, e_null_events, e_null_states, e_null_states::initial>
+        {
+            using event_t = e_null_events;
+            using state_t = e_null_states;
+            using EventToStateTable_t = StateTable<null_parser_t, state_t, event_t>;
+
+        public:
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial, { { event_t::letter_n, { state_t::got_n,   &null_parser_t::on_n     } },
+                                          { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_n,   { { event_t::letter_u, { state_t::got_u,   &null_parser_t::on_u     } },
+                                          { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_u,   { { event_t::letter_l, { state_t::got_l,   &null_parser_t::on_l     } },
+                                          { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_l,   { { event_t::letter_l, { state_t::done,    &null_parser_t::on_done  } },
+                                          { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                    { state_t::done,    { { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                    { state_t::failure, { { event_t::other,    { state_t::failure, &null_parser_t::on_fail  } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& c) const override;
+
+            // Own methods
+            result_t on_n(const symbol_t& c, const pos_t pos);
+
+            result_t on_u(const symbol_t& c, const pos_t pos);
+
+            result_t on_l(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+        };
+    #pragma endregion
+    //
+    #pragma region -- bool parser declaration -- 
+        enum class e_bool_states
+        {
+            initial,
+            got_t,
+            got_r,
+            got_u,
+            got_f,
+            got_a,
+            got_l,
+            got_s,
+            done,
+            failure,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_bool_events
+        {
+            letter_a,
+            letter_e,
+            letter_f,
+            letter_l,
+            letter_r,
+            letter_s,
+            letter_t,
+            letter_u,
+            symbol,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class bool_parser_t
+            : public parser_impl<bool_parser_t, boolean_t, e_bool_events, e_bool_states, e_bool_states::initial>
+        {
+            using event_t = e_bool_events;
+            using state_t = e_bool_states;
+            using EventToStateTable_t = StateTable<bool_parser_t, state_t, event_t>;
+        public:
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial, { { event_t::letter_t, { state_t::got_t,   &bool_parser_t::on_t     } },
+                                          { event_t::letter_f, { state_t::got_f,   &bool_parser_t::on_f     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_t,   { { event_t::letter_r, { state_t::got_r,   &bool_parser_t::on_r     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_r,   { { event_t::letter_u, { state_t::got_u,   &bool_parser_t::on_u     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_u,   { { event_t::letter_e, { state_t::done,    &bool_parser_t::on_done  } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_f,   { { event_t::letter_a, { state_t::got_a,   &bool_parser_t::on_a     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_a,   { { event_t::letter_l, { state_t::got_l,   &bool_parser_t::on_l     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_l,   { { event_t::letter_s, { state_t::got_s,   &bool_parser_t::on_s     } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::got_s,   { { event_t::letter_e, { state_t::done,    &bool_parser_t::on_done  } },
+                                          { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::done,    { { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                    { state_t::failure, { { event_t::symbol,   { state_t::failure, &bool_parser_t::on_fail  } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& c) const override;
+
+            // Own methods
+            result_t on_t(const symbol_t& c, const pos_t pos);
+
+            result_t on_r(const symbol_t& c, const pos_t pos);
+
+            result_t on_u(const symbol_t& c, const pos_t pos);
+
+            result_t on_f(const symbol_t& c, const pos_t pos);
+
+            result_t on_a(const symbol_t& c, const pos_t pos);
+
+            result_t on_l(const symbol_t& c, const pos_t pos);
+
+            result_t on_s(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+        protected:
+            string m_str;
+        };
+    #pragma endregion 
+    //
+    #pragma region -- value parser declaration -- 
+        enum class e_value_states
+        {
+            initial,
+            read,
+            done,
+            failure,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_value_events
+        {
+            symbol,
+            val_done,
+            nothing,
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class value_parser_t
+            : public parser_impl<value_parser_t, nullptr_t, e_value_events, e_value_states, e_value_states::initial>
+        {
+            using event_t               = e_value_events;
+            using state_t               = e_value_states;
+            using EventToStateTable_t   = StateTable<value_parser_t, state_t, event_t>;
+            using kind_t                = detail::value_kind;
+        public:
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial, { { event_t::symbol,   { state_t::read,    &value_parser_t::on_data  } },
+                    } },
+                    { state_t::read,    { { event_t::symbol,   { state_t::read,    &value_parser_t::on_data  } },
+                                          { event_t::val_done, { state_t::done,    &value_parser_t::on_done  } },
+                    } },
+                    { state_t::done,    { { event_t::symbol,   { state_t::failure, &value_parser_t::on_fail  } },
+                    } },
+                    { state_t::failure, { { event_t::symbol,   { state_t::failure, &value_parser_t::on_fail  } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual size_t putrun(const symbol_t* data, const size_t len, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            virtual value take() final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& c) const override;
+
+            // Own methods
+            result_t on_data(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+            /// Creates the parser of the values of the kind
+            static parser* create(const kind_t kind);
+
+        protected:
+            /// The parsers of every kind, created on the first value of the kind and reused after a reset
+            typename parser::ptr m_parsers[(size_t)kind_t::count];
+            /// The parser of the current value, selected by its first symbol
+            parser* m_active = nullptr;
+        };
+    #pragma endregion
+    //
+    #pragma region -- array parser declaration -- 
+        enum class e_array_states
+        {
+            initial,    //
+            val_before, //
+            val_inside, //
+            val_after,  //
+            done,       //
+            failure,    //
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_array_events
+        {
+            arr_begin,  // [
+            arr_end,    // ]
+            val_done,   //
+            val_error,  //
+            comma,      // ,
+            symbol,     // any symbol(depends on state)
+            skip,       // space, tab, cr, lf
+            nothing,    // no action event
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class array_parser_t
+            : public parser_impl<array_parser_t, arr, e_array_events, e_array_states, e_array_states::initial>
+        {
+            using event_t = e_array_events;
+            using state_t = e_array_states;
+            using EventToStateTable_t = StateTable<array_parser_t, state_t, event_t>;
+
+        public:
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial,    { { event_t::arr_begin, { state_t::val_before,  &array_parser_t::on_begin    } },
+                                             { event_t::skip,      { state_t::val_before,  &array_parser_t::on_more     } },
+                                             { event_t::symbol,    { state_t::failure,     &array_parser_t::on_fail     } },
+                    } },
+                    { state_t::val_before, { { event_t::symbol,    { state_t::val_inside,  &array_parser_t::on_val      } },
+                                             { event_t::skip,      { state_t::val_before,  &array_parser_t::on_more     } },
+                                             { event_t::arr_end,   { state_t::done,        &array_parser_t::on_done     } },
+                    } },
+                    { state_t::val_after,  { { event_t::arr_end,   { state_t::done,        &array_parser_t::on_done     } },
+                                             { event_t::comma,     { state_t::val_before,  &array_parser_t::on_new      } },
+                                             { event_t::skip,      { state_t::val_before,  &array_parser_t::on_more     } },
+                                             { event_t::symbol,    { state_t::failure,     &array_parser_t::on_fail     } },
+                    } },
+                    { state_t::val_inside, { { event_t::symbol,    { state_t::val_inside,  &array_parser_t::on_val      } },
+                                             { event_t::val_done,  { state_t::val_after,   &array_parser_t::on_got_val  } },
+                                             { event_t::val_error, { state_t::failure,     &array_parser_t::on_fail     } },
+                    } },
+                    { state_t::done,       { { event_t::symbol,    { state_t::failure,     &array_parser_t::on_fail     } },
+                    } },
+                    { state_t::failure,    { { event_t::symbol,    { state_t::failure,     &array_parser_t::on_fail     } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // Inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual size_t putrun(const symbol_t* data, const size_t len, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            virtual value take() final;
+
+            // Inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c) const override;
+
+            virtual event_t to_event(const result_t& r) const override;
+
+            // Own methods
+            result_t on_more(const symbol_t& c, const pos_t pos);
+
+            result_t on_begin(const symbol_t& c, const pos_t pos);
+
+            result_t on_new(const symbol_t& c, const pos_t pos);
+
+            result_t on_val(const symbol_t& c, const pos_t pos);
+
+            result_t on_got_val(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+        protected:
+            typename parser::ptr m_val_parser;
+        };
+    #pragma endregion
+    //
+    #pragma region -- object parser declaration -- 
+        enum class e_object_states
+        {
+            initial,        //
+            key_before,     //
+            key_inside,     //
+            key_after,      //
+            val_before,     //
+            val_inside,     //
+            val_after,      //
+            done,           //
+            failure,        //
+            count,      // the number of enumerators, must be the last one
+        };
+
+        enum class e_object_events
+        {
+            // ascii part
+            obj_begin,      // {
+            obj_end,        // }
+            key_done,       //
+            key_error,      //
+            val_done,       //
+            val_error,      //
+            colon,          // :
+            comma,          // ,
+            symbol,         // any symbol
+            skip,           // space, tab, cr, lf
+            nothing,        // no action event
+            count,      // the number of enumerators, must be the last one
+        };
+
+        class object_parser_t
+            : public parser_impl<object_parser_t, obj, e_object_events, e_object_states, e_object_states::initial>
+        {
+            using event_t = e_object_events;
+            using state_t = e_object_states;
+            using EventToStateTable_t = StateTable<object_parser_t, state_t, event_t>;
+
+        public:
+            // {ctor}
+            static const EventToStateTable_t& table()
+            {
+                static constexpr EventToStateTable_t s_table
+                {
+                    { state_t::initial,    { { event_t::obj_begin, { state_t::key_before, &object_parser_t::on_begin    } },
+                                             { event_t::skip,      { state_t::val_before, &object_parser_t::on_more     } },
+                                             { event_t::symbol,    { state_t::failure,    &object_parser_t::on_fail     } },
+                    } },
+                    { state_t::key_before, { { event_t::obj_end,   { state_t::done,       &object_parser_t::on_done     } },
+                                             { event_t::key_error, { state_t::failure,    &object_parser_t::on_fail     } },
+                                             { event_t::symbol,    { state_t::key_inside, &object_parser_t::on_key      } },
+                                             { event_t::skip,      { state_t::key_before, &object_parser_t::on_more     } },
+                    } },
+                    { state_t::key_inside, { { event_t::key_done,  { state_t::key_after,  &object_parser_t::on_more     } },
+                                             { event_t::key_error, { state_t::failure,    &object_parser_t::on_fail     } },
+                                             { event_t::symbol,    { state_t::key_inside, &object_parser_t::on_key      } },
+                    } },
+                    { state_t::key_after,  { { event_t::colon,     { state_t::val_before, &object_parser_t::on_more     } },
+                                             { event_t::skip,      { state_t::key_after,  &object_parser_t::on_more     } },
+                    } },
+                    { state_t::val_before, { { event_t::symbol,    { state_t::val_inside, &object_parser_t::on_val      } },
+                                             { event_t::val_error, { state_t::failure,    &object_parser_t::on_fail     } },
+                                             { event_t::skip,      { state_t::val_before, &object_parser_t::on_more     } },
+                    } },
+                    { state_t::val_inside, { { event_t::val_done,  { state_t::val_after,  &object_parser_t::on_got_val  } },
+                                             { event_t::val_error, { state_t::failure,    &object_parser_t::on_fail     } },
+                                             { event_t::symbol,    { state_t::val_inside, &object_parser_t::on_val      } },
+                    } },
+                    { state_t::val_after,  { { event_t::comma,     { state_t::key_before, &object_parser_t::on_new      } },
+                                             { event_t::obj_end,   { state_t::done,       &object_parser_t::on_done     } },
+                                             { event_t::skip,      { state_t::val_after,  &object_parser_t::on_more     } },
+                    } },
+                    { state_t::done,       { { event_t::symbol,    { state_t::failure,    &object_parser_t::on_fail     } },
+                    } },
+                    { state_t::failure,    { { event_t::symbol,    { state_t::failure,    &object_parser_t::on_fail     } },
+                    } },
+                };
+
+                return s_table;
+            }
+
+        protected:
+            // inherited via parser
+            virtual void reset() final;
+
+            virtual result_t putchar(const symbol_t& c, const pos_t pos) final;
+
+            virtual size_t putrun(const symbol_t* data, const size_t len, const pos_t pos) final;
+
+            virtual value get() const final;
+
+            virtual value take() final;
+
+            // inherited via parser_impl
+            virtual event_t to_event(const symbol_t& c)   const override;
+
+            virtual event_t to_event(const result_t& r) const override;
+
+            // own methods
+            result_t on_more(const symbol_t& c, const pos_t pos);
+
+            result_t on_begin(const symbol_t& c, const pos_t pos);
+
+            result_t on_new(const symbol_t& c, const pos_t pos);
+
+            result_t on_key(const symbol_t& c, const pos_t pos);
+
+            result_t on_val(const symbol_t& c, const pos_t pos);
+
+            result_t on_done(const symbol_t& c, const pos_t pos);
+
+            result_t on_fail(const symbol_t& c, const pos_t pos);
+
+            result_t on_got_val(const symbol_t& c, const pos_t pos);
+        protected:
+            typename parser::ptr m_key_parser;
+            typename parser::ptr m_val_parser;
+        };
+    #pragma endregion 
+    //////////////////////////////////////////////////////////////////////////
+    #pragma region -- factory --
+        /// creates object parser
+        inline static typename parser::ptr create() 
+        { 
+            return parser::ptr(new object_parser_t()); 
+        }
+
+        /// creates value parser(i.e. accepts any root value type)
+        inline static typename parser::ptr create_value()
+        {
+            return parser::ptr(new value_parser_t());
+        }
+    #pragma endregion
+    //
+    #pragma region -- session declaration --
+        /// Resumable push-parser session. Takes the JSON text in chunks of any size, the tokens split between
+        /// chunks(escapes, \uXXXX, numbers, literals) are handled by the underlying state machines.
+        class session
+        {
+        public:
+            /// {ctor} takes the root parser, the value parser(i.e. any root value type) by default
+            explicit session(typename parser::ptr root = create_value());
+
+            /// Drops the session to initial state, the root parser is reused
+            void reset();
+
+            /// Caps the number of symbols a single feed() call processes, 0 - no limit
+            void limit(const size_t max_symbols);
+
+            /// Puts the chunk [data, data + len) to the parser. Returns s_need_more if more data is needed(or the limit
+            /// is reached - check consumed()), s_done once the root value is complete or an error.
+            result_t feed(const symbol_t* data, const size_t len);
+
+            /// Signals the end of data. Terminates the pending token(i.e. the root number).
+            result_t finish();
+
+            /// Feeds the whole buffer and finishes
+            result_t parse(const symbol_t* data, const size_t len);
+
+            /// The number of symbols consumed by the last feed() call
+            size_t consumed() const { return m_consumed; }
+
+            /// The root value has started, i.e. a symbol other than a whitespace has been fed
+            boolean_t started() const { return m_started; }
+
+            /// The last result
+            result_t result() const { return m_result; }
+
+            /// Retrieves the parsed root value
+            value get() const;
+
+            /// Moves the parsed root value out, the session must be reset before the next document
+            value take();
+
+        protected:
+            typename parser::ptr m_root;
+
+            size_t      m_limit     = 0;
+            size_t      m_consumed  = 0;
+            pos_t       m_pos       = 0;
+            boolean_t   m_started   = false;
+            result_t    m_result    = result_t::s_need_more;
+        };
+    #pragma endregion
+    //
+    #pragma region -- parse context declaration --
+        /// Reusable parsing context, i.e. one per thread. Keeps the parser trees of both root kinds between documents:
+        /// every container parser retains the parser of its values(one per nesting level, the value parsers retain
+        /// a parser per value kind) and the whole tree is reset in place. Once a document of the same shape has been
+        /// parsed the parser state needs no heap allocations. Not thread safe.
+        class parse_context
+        {
+        public:
+            parse_context();
+
+            /// Parses the JSON text of any root type from the contiguous buffer [begin, begin + len)
+            result_t parse(const symbol_t* begin, const size_t len, value& jsval);
+
+            /// Parses the JSON object from the contiguous buffer [begin, begin + len)
+            result_t parse(const symbol_t* begin, const size_t len, obj& jsobj);
+
+            result_t parse(const string& input, value& jsval) { return parse(input.data(), input.size(), jsval); }
+
+            result_t parse(const string& input, obj& jsobj) { return parse(input.data(), input.size(), jsobj); }
+
+        protected:
+            session m_value_session;
+            session m_object_session;
+        };
+    #pragma endregion
+    //
+    #pragma region -- document reader declaration --
+        /// Reads the successive root values(of any type) from one input: newline delimited JSON(NDJSON), concatenated
+        /// JSON(values back to back or separated by whitespaces) and RFC 7464 JSON text sequences(every record starts
+        /// by RS, 0x1E). The documents are found by the parser itself, every symbol is looked at once. A stream is read
+        /// by chunks of the fixed size, the parser tree is reset in place between documents, so the memory stays
+        /// constant however long the stream is.
+        class document_reader
+        {
+        public:
+            /// {ctor} reads the stream by chunks of the given size
+            explicit document_reader(istream& input, const size_t chunk_size = 64 * 1024);
+
+            /// {ctor} reads the buffer [data, data + len), the buffer must outlive the reader
+            document_reader(const symbol_t* data, const size_t len);
+
+            /// Reads the next document. Returns s_done once a document is read, s_ok at the end of the input,
+            /// s_need_more if the input ends in the middle of a document or an error. After an error the reader skips
+            /// the rest of the record, i.e. up to the next line feed or RS, and goes on with the next one.
+            result_t next(value& jsval);
+
+            /// The number of documents read
+            size_t count() const { return m_count; }
+
+        protected:
+            /// Reads the next chunk of the stream, false at the end of the input
+            boolean_t fill();
+
+            session             m_session;
+            istream*            m_input     = nullptr;
+            vector_t<symbol_t>  m_chunk;
+            const symbol_t*     m_data      = nullptr;
+            size_t              m_len       = 0;
+            size_t              m_offset    = 0;
+            size_t              m_count     = 0;
+            boolean_t           m_skip      = false;    // skipping the rest of the broken record
+        };
+    #pragma endregion
+    //
+    #pragma region -- pull reader declaration --
+        /// The tokens of the pull reader
+        enum class token_t
+        {
+            none,           // nothing is read yet
+            object_begin,   // {
+            object_end,     // }
+            array_begin,    // [
+            array_end,      // ]
+            key,            // the member key, see str()
+            string,         // see str()
+            integer,        // see integer()
+            floatingpt,     // see floatingpt()
+            boolean,        // see boolean()
+            null,
+            end,            // the end of the input
+            error,          // see result()
+        };
+
+        /// Pull cursor over the JSON text: the caller asks for the tokens one by one, no tree is built and nothing is
+        /// allocated except for unescaping strings. Reads a contiguous buffer or a stream by chunks(the chunk grows
+        /// only for a token longer than it). Successive root values(i.e. NDJSON) are read as one token sequence.
+        class reader
+        {
+        public:
+            /// {ctor} reads the stream by chunks of the given size
+            explicit reader(istream& input, const size_t chunk_size = 64 * 1024);
+
+            /// {ctor} reads the buffer [data, data + len), the buffer must outlive the reader
+            reader(const symbol_t* data, const size_t len);
+
+            /// Reads the next token. After an error the reader keeps returning token_t::error.
+            token_t next();
+
+            /// Moves past the container just opened(the next token is the one after its end) or past the value of the
+            /// key just read. Within the skipped text only the strings and the bracket balance are checked.
+            result_t skip();
+
+            /// The current token
+            token_t token() const { return m_token; }
+
+            /// The key or the string, valid until the next call
+            const string_view& str() const { return m_view; }
+
+            /// The number as an integer
+            integer_t integer() const { return m_scalar.get<integer_t>(); }
+
+            /// The number as a floating point(integers are converted)
+            floatingpt_t floatingpt() const { return m_scalar.is_integer() ? (floatingpt_t)m_scalar.get<integer_t>() : m_scalar.get<floatingpt_t>(); }
+
+            /// The boolean
+            boolean_t boolean() const { return m_scalar.get<boolean_t>(); }
+
+            /// The number of the open containers
+            size_t depth() const { return m_stack.size(); }
+
+            /// The error of the token_t::error, s_need_more if the input ends in the middle of a value
+            result_t result() const { return m_result; }
+
+        protected:
+            enum class expect
+            {
+                value,              // any value(the root one if the stack is empty)
+                first_value_or_end, // a value or ]
+                first_key_or_end,   // a key or }
+                key,                // a key
+                colon,              // :
+                comma_or_end,       // , or the end of the current container
+            };
+
+            /// Keeps the unread symbols and reads the next chunk after them, false at the end of the input
+            boolean_t fill();
+
+            /// Finds the closing quote of the string starting at m_pos, plain tells whether there are no escapes
+            result_t string_end(size_t& end, boolean_t& plain);
+
+            result_t scan_string();
+
+            result_t scan_scalar();
+
+            /// The expectation after a complete value
+            void after_value() { m_expect = m_stack.empty() ? expect::value : expect::comma_or_end; }
+
+            token_t fail(const result_t result) { m_result = result; return m_token = token_t::error; }
+
+            istream*            m_input     = nullptr;
+            vector_t<symbol_t>  m_chunk;
+            size_t              m_chunk_size = 0;
+            const symbol_t*     m_data      = nullptr;
+            size_t              m_len       = 0;
+            size_t              m_pos       = 0;
+
+            vector_t<boolean_t> m_stack;    // the open containers, true - object, false - array
+            expect              m_expect    = expect::value;
+            token_t             m_token     = token_t::none;
+            result_t            m_result    = result_t::s_ok;
+
+            string_view         m_view;
+            string              m_string;   // the last unescaped string
+            value               m_scalar;
+        };
+    #pragma endregion
+    //
+    #pragma region -- mapped file declaration --
+        /// Read only memory mapping of the whole file. The pages are the page cache ones, nothing is copied, and are read
+        /// ahead sequentially. Any parse or reader taking a buffer works on data(), size().
+        class mapped_file
+        {
+        public:
+            mapped_file() = default;
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            ~mapped_file() { close(); }
+
+            /// Maps the file. Returns s_ok or e_fatal if the file can not be opened or mapped.
+            result_t open(const std::string& path);
+
+            /// Unmaps the file
+            void close();
+
+            /// The file contents
+            const symbol_t* data() const { return static_cast<const symbol_t*>(m_data); }
+
+            /// The number of symbols in the file
+            size_t size() const { return m_size / sizeof(symbol_t); }
+
+        protected:
+            const void* m_data = nullptr;
+            size_t      m_size = 0;    // bytes
+        };
+
+        /// Parses the file by its memory mapping(see mapped_file). Returns e_fatal if the file can not be mapped.
+        static result_t parse_file(const std::string& path, value& jsval, const options& opts = options())
+        {
+            mapped_file file;
+
+            const result_t result = file.open(path);
+            if (failed(result))
+                return result;
+
+            return parse(file.data(), file.size(), jsval, opts);
+        }
+
+        /// Parses the JSON object from the file by its memory mapping(see mapped_file)
+        static result_t parse_file(const std::string& path, obj& jsobj, const options& opts = options())
+        {
+            mapped_file file;
+
+            const result_t result = file.open(path);
+            if (failed(result))
+                return result;
+
+            return parse(file.data(), file.size(), jsobj, opts);
+        }
+    #pragma endregion
+    //
+    #pragma region -- token decoders --
+        /// Decodes the string body(i.e. the symbols between quotes) [begin, end) resolving escape sequences
+        static result_t decode_string(const symbol_t* begin, const symbol_t* end, string& out);
+
+        /// Decodes the number token [begin, end)
+        static result_t decode_number(const symbol_t* begin, const symbol_t* end, value& out);
+
+        /// Decodes the scalar token [begin, end): number, true, false or null
+        static result_t decode_scalar(const symbol_t* begin, const symbol_t* end, value& out);
+
+        /// Appends the unicode code point to the string as UTF-8(or as is if the symbol is wider than a byte)
+        static void append_code_point(string& out, const uint32_t cp);
+
+        /// The length of the leading run of string symbols that need no special handling(see detail::plain_run)
+        static size_t plain_run(const symbol_t* data, const size_t len)
+        {
+            if (1 == sizeof(symbol_t))
+                return detail::plain_run(reinterpret_cast<const uint8_t*>(data), len);
+
+            size_t i = 0;
+            while (i < len && 0x22 != data[i] && 0x5C != data[i] && (data[i] < 0 || 0x20 <= data[i]))
+                ++i;
+            return i;
+        }
+
+        /// The first delim symbol at the nesting level of begin outside the strings, or the closing bracket of the
+        /// enclosing container, or end
+        static const symbol_t* next_delimiter(const symbol_t* begin, const symbol_t* end, const symbol_t delim);
+    #pragma endregion
+    //
+    #pragma region -- structural parser declaration --
+        /// Two stage parser engine. Stage 1 classifies the buffer by 64 byte blocks(SIMD where available) and builds
+        /// the index of structural symbols - { } [ ] : , the quotes outside escapes and the starts of scalars.
+        /// Stage 2 walks the index only and builds the tree. Needs the complete document in a contiguous buffer.
+        class structural_parser_t
+        {
+        public:
+            /// Parses the buffer [data, data + len)
+            result_t parse(const symbol_t* data, const size_t len, value& jsval);
+
+            /// Stage 1: builds the structural index
+            result_t index(const symbol_t* data, const size_t len);
+
+            /// Stage 2: builds the tree over the structural index
+            result_t build(const symbol_t* data, const size_t len, value& jsval);
+
+            /// The structural index built by the last index() call
+            const vector_t<size_t>& indices() const { return m_indices; }
+
+        protected:
+            /// An object or array under construction
+            struct frame
+            {
+                boolean_t   is_object = false;
+                obj         o;
+                arr         a;
+                string      key;
+            };
+
+            vector_t<size_t> m_indices;
+        };
+    #pragma endregion
+    //
+    #pragma region -- flat parser declaration --
+        /// Single pass parser engine: one grammar automaton over the whole buffer, the nesting is kept by an explicit
+        /// stack of the open containers, so there is one dispatch per symbol whatever the depth and no recursion.
+        /// Reports the document to the handler, which has to provide(a failed result stops the parsing):
+        ///     result_t on_null();
+        ///     result_t on_boolean(const boolean_t b);
+        ///     result_t on_integer(const integer_t i);
+        ///     result_t on_floatingpt(const floatingpt_t f);
+        ///     result_t on_string(string& str);      // the string may be moved out
+        ///     result_t on_key(string& key);         // the string may be moved out
+        ///     result_t on_object_begin();
+        ///     result_t on_object_end();
+        ///     result_t on_array_begin();
+        ///     result_t on_array_end();
+        /// A handler declaring static const bool borrows_strings = true; gets the strings without escapes as views into
+        /// the input instead, only the escaped ones are decoded:
+        ///     result_t on_string_view(const string_view& str);
+        ///     result_t on_key_view(const string_view& key);
+        /// Needs the complete document in a contiguous buffer.
+        template <class HandlerT>
+        class flat_parser_t
+        {
+        public:
+            /// {ctor} max_depth - the nesting depth limit, 0 - no limit
+            explicit flat_parser_t(HandlerT& handler, const size_t max_depth = 0)
+                : m_handler(handler)
+                , m_max_depth(max_depth)
+            {
+            }
+
+            /// Parses the buffer [data, data + len). Returns s_done, s_need_more if the document is incomplete or an error.
+            result_t parse(const symbol_t* data, const size_t len);
+
+        protected:
+            /// Scans the string starting by the quote at data[i], i is moved past the closing quote. The string body is
+            /// kept in m_view if it has no escapes, otherwise it is decoded to m_string.
+            result_t scan_string(const symbol_t* data, const size_t len, size_t& i);
+
+            /// Reports the last string scanned as a value or a key, by view if the handler borrows strings
+            result_t report_string(const boolean_t is_key, std::true_type borrows);
+            result_t report_string(const boolean_t is_key, std::false_type borrows);
+
+            /// Scans the scalar(number, true, false or null) starting at data[i] and reports it, i is moved past it
+            result_t scan_scalar(const symbol_t* data, const size_t len, size_t& i);
+
+            HandlerT&           m_handler;
+            const size_t        m_max_depth;
+            vector_t<boolean_t> m_stack;    // the open containers, true - object, false - array
+            string              m_string;   // the last string scanned if it has escapes
+            string_view         m_view;     // the last string scanned if it has no escapes
+            boolean_t           m_plain = true;
+            value               m_scalar;   // the last scalar scanned
+        };
+
+        /// flat_parser_t handler building the tree
+        class dom_builder_t
+        {
+        public:
+            /// {ctor} the root is assigned once the root value is complete
+            explicit dom_builder_t(value& root)
+                : m_root(root)
+            {
+            }
+
+            result_t on_null()                              { return emit(value(null_t())); }
+            result_t on_boolean(const boolean_t b)          { return emit(value(b)); }
+            result_t on_integer(const integer_t i)          { return emit(value(i)); }
+            result_t on_floatingpt(const floatingpt_t f)    { return emit(value(f)); }
+            result_t on_string(string& str)                 { return emit(value(std::move(str))); }
+            result_t on_key(string& key)                    { m_stack[m_depth - 1].key.swap(key); return result_t::s_ok; }
+            result_t on_object_begin()                      { return open(true); }
+            result_t on_object_end()                        { return close(); }
+            result_t on_array_begin()                       { return open(false); }
+            result_t on_array_end()                         { return close(); }
+
+            /// Drops the unfinished containers, i.e. after a failed document
+            void reset() { m_depth = 0; }
+
+        protected:
+            result_t open(const boolean_t is_object);
+
+            result_t close();
+
+            /// puts the complete value to the enclosing container or to the root
+            result_t emit(value&& v);
+
+            /// An object or array under construction
+            struct frame
+            {
+                boolean_t   is_object = false;
+                obj         o;
+                arr         a;
+                string      key;
+            };
+
+            value&          m_root;
+            vector_t<frame> m_stack;        // the frames are kept once created and reused by the depth
+            size_t          m_depth = 0;
+        };
+    #pragma endregion
+    //
+    #pragma region -- event handler API --
+        /// The base of the parse_events handlers: every event is accepted and ignored, a handler hides the ones it
+        /// needs(see flat_parser_t for the events). The calls are resolved at compile time, no virtual dispatch.
+        struct event_handler
+        {
+            result_t on_null()                              { return result_t::s_ok; }
+            result_t on_boolean(const boolean_t)            { return result_t::s_ok; }
+            result_t on_integer(const integer_t)            { return result_t::s_ok; }
+            result_t on_floatingpt(const floatingpt_t)      { return result_t::s_ok; }
+            result_t on_string(string&)                     { return result_t::s_ok; }
+            result_t on_key(string&)                        { return result_t::s_ok; }
+            result_t on_string_view(const string_view&)     { return result_t::s_ok; }
+            result_t on_key_view(const string_view&)        { return result_t::s_ok; }
+            result_t on_object_begin()                      { return result_t::s_ok; }
+            result_t on_object_end()                        { return result_t::s_ok; }
+            result_t on_array_begin()                       { return result_t::s_ok; }
+            result_t on_array_end()                         { return result_t::s_ok; }
+        };
+
+        /// Parses the buffer [data, data + len) reporting the document to the handler without building any tree.
+        /// A failed result of the handler stops the parsing and is returned. max_depth - the nesting depth limit,
+        /// 0 - no limit.
+        template <class HandlerT>
+        static result_t parse_events(const symbol_t* data, const size_t len, HandlerT& handler, const size_t max_depth = 0)
+        {
+            flat_parser_t<HandlerT> p(handler, max_depth);
+            return p.parse(data, len);
+        }
+
+        template <class HandlerT>
+        static result_t parse_events(const string& input, HandlerT& handler, const size_t max_depth = 0)
+        {
+            return parse_events(input.data(), input.size(), handler, max_depth);
+        }
+    #pragma endregion
+    //
+    #pragma region -- borrowed document declaration --
+        /// The tree whose strings and keys without escapes are views into the input buffer(or into the mapped file),
+        /// only the escaped ones are decoded to the document's own storage. The buffer must outlive the document, the
+        /// nodes must not outlive the document. Built by the flat engine.
+        class document
+        {
+        public:
+            class node;
+
+            /// The object members in the document order
+            class members
+                : public vector_t<pair_t<string_view, node>>
+            {
+            public:
+                /// The first member by the key or nullptr
+                const node* find(const string_view& key) const;
+            };
+
+            /// The array elements
+            class elements
+                : public vector_t<node>
+            {
+            };
+
+#if _HAS_CXX17
+            using node_base_t = std::variant<string_view, members, elements, integer_t, floatingpt_t, boolean_t, null_t>;
+#else
+            using node_base_t = boost::variant<string_view, members, elements, integer_t, floatingpt_t, boolean_t, null_t>;
+#endif
+
+            /// The tree node, the alternatives are in the value::vt order
+            class node
+                : public node_base_t
+            {
+            public:
+                /// {ctor}s
+                node() {}
+                node(const string_view& other)      : node_base_t(other)            {}
+                node(members&& other)               : node_base_t(std::move(other)) {}
+                node(elements&& other)              : node_base_t(std::move(other)) {}
+                node(const integer_t other)         : node_base_t(other)            {}
+                node(const floatingpt_t other)      : node_base_t(other)            {}
+                node(const boolean_t other)         : node_base_t(other)            {}
+                node(const null_t other)            : node_base_t(other)            {}
+
+#if _HAS_CXX17
+                typename value::vt index() const {
+                    return (typename value::vt)node_base_t::index();
+                }
+                template <class T>
+                const T& get() const {
+                    return std::get<T>(*this);
+                }
+#else
+                typename value::vt index() const {
+                    return (typename value::vt)node_base_t::which();
+                }
+                template <class T>
+                const T& get() const {
+                    return boost::get<T>(*this);
+                }
+#endif
+
+                inline bool is_string()     const { return value::vt::t_string     == index(); }
+                inline bool is_object()     const { return value::vt::t_object     == index(); }
+                inline bool is_array()      const { return value::vt::t_array      == index(); }
+                inline bool is_integer()    const { return value::vt::t_integer    == index(); }
+                inline bool is_floatingpt() const { return value::vt::t_floatingpt == index(); }
+                inline bool is_boolean()    const { return value::vt::t_boolean    == index(); }
+                inline bool is_null()       const { return value::vt::t_null       == index(); }
+
+                /// The member by the key, throws if the node is not an object or has no such member
+                const node& operator[](const string_view& key) const;
+
+                /// The element by the index, throws if the node is not an array
+                const node& operator[](const size_t idx) const;
+
+                /// The owning copy of the subtree
+                value to_value() const;
+            };
+
+            document() = default;
+            document(document&&) = default;
+            document& operator=(document&&) = default;
+
+            /// Parses the buffer [data, data + len), the buffer must outlive the document. max_depth - the nesting
+            /// depth limit, 0 - no limit.
+            result_t parse(const symbol_t* data, const size_t len, const size_t max_depth = 0);
+
+            /// Parses the file by its memory mapping(see mapped_file), the document keeps the mapping
+            result_t parse_file(const std::string& path, const size_t max_depth = 0);
+
+            /// The root node
+            const node& root() const { return m_root; }
+
+            /// The number of strings and keys decoded to the document's own storage, i.e. the escaped ones
+            size_t decoded() const { return m_strings.size(); }
+
+        protected:
+            /// flat_parser_t handler building the document tree
+            class builder_t
+            {
+            public:
+                static const bool borrows_strings = true;
+
+                explicit builder_t(document& doc)
+                    : m_doc(doc)
+                {
+                }
+
+                result_t on_null()                              { return emit(node(null_t())); }
+                result_t on_boolean(const boolean_t b)          { return emit(node(b)); }
+                result_t on_integer(const integer_t i)          { return emit(node(i)); }
+                result_t on_floatingpt(const floatingpt_t f)    { return emit(node(f)); }
+                result_t on_string_view(const string_view& str) { return emit(node(str)); }
+                result_t on_key_view(const string_view& key)    { m_stack[m_depth - 1].key = key; return result_t::s_ok; }
+                result_t on_string(string& str)                 { return emit(node(keep(str))); }
+                result_t on_key(string& key)                    { m_stack[m_depth - 1].key = keep(key); return result_t::s_ok; }
+                result_t on_object_begin()                      { return open(true); }
+                result_t on_object_end()                        { return close(); }
+                result_t on_array_begin()                       { return open(false); }
+                result_t on_array_end()                         { return close(); }
+
+            protected:
+                /// Moves the decoded string to the document storage
+                string_view keep(string& str);
+
+                result_t open(const boolean_t is_object);
+
+                result_t close();
+
+                /// puts the complete node to the enclosing container or to the root
+                result_t emit(node&& n);
+
+                /// An object or array under construction
+                struct frame
+                {
+                    boolean_t   is_object = false;
+                    members     o;
+                    elements    a;
+                    string_view key;
+                };
+
+                document&       m_doc;
+                vector_t<frame> m_stack;
+                size_t          m_depth = 0;
+            };
+
+            node                            m_root;
+            list_t<string>                  m_strings;  // the list keeps the strings in place, the views stay valid
+            std::unique_ptr<mapped_file>    m_file;
+        };
+    #pragma endregion
+    //
+    #pragma region -- lazy document declaration --
+        /// The text range of a lazy value and, for a container, the members found so far
+        struct lazy_node
+        {
+            /// The member(or the element) found in the container text
+            struct member
+            {
+                string_view key;                // the raw key, between the quotes
+                boolean_t   escaped = false;    // the key has escapes
+                lazy_node*  node    = nullptr;
+            };
+
+            const symbol_t*     begin       = nullptr;
+            const symbol_t*     end         = nullptr;
+            const symbol_t*     scan        = nullptr;  // the text of the next member
+            boolean_t           complete    = false;    // all the members are found
+            vector_t<member>    members;
+        };
+
+        /// The handle of a value of the lazy document: the text range only, converted on access. The containers are
+        /// scanned forward as far as the requested member, the members found are kept, so the parts of the document
+        /// never asked for are neither parsed nor validated. Malformed text met on access throws std::logic_error.
+        /// The handle is valid as long as its document, the document is not thread safe.
+        class lazy_value
+        {
+        public:
+            /// Forward iterator over the members of the object or the elements of the array
+            class iterator
+            {
+            public:
+                iterator(list_t<lazy_node>* nodes, lazy_node* node, const size_t idx);
+
+                /// The member key(the objects only)
+                string key() const;
+
+                lazy_value operator*() const;
+
+                iterator& operator++();
+
+                bool operator==(const iterator& other) const;
+                bool operator!=(const iterator& other) const { return !operator==(other); }
+
+            protected:
+                list_t<lazy_node>*  m_nodes;
+                lazy_node*          m_node;
+                size_t              m_idx;      // SIZE_MAX - the end
+            };
+
+            lazy_value(list_t<lazy_node>* nodes, lazy_node* node)
+                : m_nodes(nodes)
+                , m_node(node)
+            {
+            }
+
+            /// The type by the text, the numbers are decoded to tell integers from floating points
+            typename value::vt index() const;
+
+            inline bool is_string()     const { return value::vt::t_string     == index(); }
+            inline bool is_object()     const { return value::vt::t_object     == index(); }
+            inline bool is_array()      const { return value::vt::t_array      == index(); }
+            inline bool is_integer()    const { return value::vt::t_integer    == index(); }
+            inline bool is_floatingpt() const { return value::vt::t_floatingpt == index(); }
+            inline bool is_number()     const { return is_integer() || is_floatingpt(); };
+            inline bool is_boolean()    const { return value::vt::t_boolean    == index(); }
+            inline bool is_null()       const { return value::vt::t_null       == index(); }
+
+            /// The member by the key, throws std::out_of_range if there is no such member
+            lazy_value operator[](const string& key) const;
+
+            /// The element by the index, throws std::out_of_range if there is no such element
+            lazy_value operator[](const size_t idx) const;
+
+            /// Tells whether the object has the member
+            boolean_t exists(const string& key) const;
+
+            /// The number of the members or the elements, scans the whole container
+            size_t size() const;
+
+            iterator begin() const;
+            iterator end() const;
+
+            /// The raw text of the value
+            string_view text() const { return string_view(m_node->begin, m_node->end - m_node->begin); }
+
+            /// Parses the whole value to the tree
+            value to_value() const;
+
+            operator obj() const                    { return to_value(); }
+            operator arr() const                    { return to_value(); }
+            explicit operator string() const;
+            explicit operator int64_t() const;
+            explicit operator floatingpt_t() const;
+            explicit operator boolean_t() const;
+            explicit operator null_t() const;
+            explicit operator int32_t() const       { return (int32_t)(operator int64_t()); }
+            explicit operator int16_t() const       { return (int16_t)(operator int64_t()); }
+
+        protected:
+            /// Finds the next member of the container, false if there are no more
+            static boolean_t scan_next(list_t<lazy_node>* nodes, lazy_node* node);
+
+            /// The member of the object by the key or nullptr
+            lazy_node* find(const string& key) const;
+
+            /// Decodes the scalar, throws if malformed
+            value scalar() const;
+
+            list_t<lazy_node>*  m_nodes;    // the document's nodes, the list keeps them in place
+            lazy_node*          m_node;
+        };
+
+        /// The document parsed on demand(see lazy_value). The buffer must outlive the document.
+        class lazy_document
+        {
+        public:
+            lazy_document()
+                : m_nodes(new list_t<lazy_node>())
+            {
+            }
+
+            /// Takes the buffer [data, data + len). Only the bounds of the root value are checked.
+            result_t parse(const symbol_t* data, const size_t len);
+
+            result_t parse(const string& input) { return parse(input.data(), input.size()); }
+
+            /// The document would outlive the temporary buffer
+            result_t parse(string&& input) = delete;
+
+            /// The root value, throws std::logic_error if there is no document(see empty)
+            lazy_value root() const
+            {
+                if (m_nodes->empty())
+                    throw std::logic_error("No document.");
+
+                return lazy_value(m_nodes.get(), &m_nodes->front());
+            }
+
+            /// Tells whether there is no document, i.e. nothing parsed yet or the last parse failed
+            boolean_t empty() const { return m_nodes->empty(); }
+
+        protected:
+            std::unique_ptr<list_t<lazy_node>> m_nodes;
+        };
+    #pragma endregion
+    //
+    #pragma region -- projection declaration --
+        /// The compiled set of JSON pointers(RFC 6901, i.e. "/result/sessid", "/items/0", "" - the whole document) to
+        /// extract from a document(see parse below). The paths are merged into a tree of steps by their common prefixes.
+        class projection
+        {
+        public:
+            /// {ctor}s, throws std::invalid_argument if a path is not a JSON pointer
+            projection(std::initializer_list<string> paths);
+            explicit projection(const vector_t<string>& paths);
+
+            /// The number of paths
+            size_t size() const { return m_size; }
+
+            /// Walks the document [data, data + len) down the paths, the paths found are parsed to the values
+            result_t extract(const symbol_t* data, const size_t len, vector_t<value>& values) const;
+
+        protected:
+            /// The step of the paths: the object key or the array index
+            struct step
+            {
+                vector_t<pair_t<string, size_t>>    children;   // the token and the step index
+                vector_t<pair_t<size_t, size_t>>    indices;    // the tokens being array indices and the step index
+                vector_t<size_t>                    paths;      // the paths ending here
+            };
+
+            /// The extraction state
+            struct walk_state
+            {
+                const symbol_t*     end;
+                vector_t<value>&    values;
+                vector_t<boolean_t> done;       // the steps extracted
+                size_t              remaining;  // the steps to extract
+                string              key;        // the last escaped key
+            };
+
+            void add(const string& path);
+
+            /// Walks the value at p down the step n, p is moved past the value
+            result_t walk(walk_state& st, const symbol_t*& p, const size_t n) const;
+
+            /// Extracts the paths below the step n from the value extracted for it
+            void resolve(walk_state& st, const value& v, const size_t n) const;
+
+            /// The child step matching the key, SIZE_MAX if none
+            size_t child(const size_t n, const symbol_t* key, const size_t len) const;
+
+            /// The child step matching the array index, SIZE_MAX if none
+            size_t child(const size_t n, const size_t idx) const;
+
+            vector_t<step>  m_steps;    // 0 - the root
+            size_t          m_size = 0;
+        };
+
+        /// Parses only the subtrees at the paths, everything else is skipped by the bracket and quote aware scanner
+        /// without decoding the strings or the numbers(and not validated). The parsing stops once every path is found.
+        /// values[i] gets the value at the paths[i] or null if there is no such value.
+        static result_t parse(const symbol_t* data, const size_t len, const projection& paths, vector_t<value>& values)
+        {
+            return paths.extract(data, len, values);
+        }
+
+        static result_t parse(const string& input, const projection& paths, vector_t<value>& values)
+        {
+            return paths.extract(input.data(), input.size(), values);
+        }
+    #pragma endregion
+    //
+    #pragma region -- intern table declaration --
+        /// Table of the interned strings(atoms) shared by the documents and the threads. An atom is immutable and lives
+        /// as long as the table, the equal strings resolve to the same atom, so the atoms are compared by pointer.
+        /// Concurrency: intern() and find() are lock free and may be called by any number of parsers at once. The
+        /// table is an open addressing array of atomic atom pointers: a new atom is published by compare-and-swap
+        /// of an empty slot, the thread losing the race for the slot takes the winner's atom if the strings are equal
+        /// and frees its own. The table does not grow: past 3/4 of the capacity intern() returns nullptr and the
+        /// parsers keep their own copies of the strings, so the capacity is to be chosen for the vocabulary of the keys
+        /// rather than for the traffic. The atoms are never removed while the table exists.
+        class intern_table
+        {
+        public:
+            /// The interned string, the symbols follow the header
+            struct atom
+            {
+                uint64_t    hash;
+                size_t      size;
+
+                const symbol_t* data() const { return reinterpret_cast<const symbol_t*>(this + 1); }
+
+                string_view view() const { return string_view(data(), size); }
+            };
+
+            /// capacity - the number of the slots, rounded up to a power of 2
+            explicit intern_table(const size_t capacity = 64 * 1024);
+
+            intern_table(const intern_table&) = delete;
+            intern_table& operator=(const intern_table&) = delete;
+
+            ~intern_table();
+
+            /// The atom of the string, nullptr if the table is full
+            const atom* intern(const string_view& str);
+
+            /// The atom of the string, nullptr if the string is not interned
+            const atom* find(const string_view& str) const;
+
+            /// The number of the atoms
+            size_t size() const { return m_size.load(std::memory_order_relaxed); }
+
+        protected:
+            static uint64_t hash(const string_view& str) { return detail::hash_bytes(str.data(), str.size() * sizeof(symbol_t)); }
+
+            const size_t                                    m_mask;
+            const size_t                                    m_limit;
+            std::unique_ptr<std::atomic<const atom*>[]>     m_slots;
+            std::atomic<size_t>                             m_size;
+        };
+    #pragma endregion
+    //
+    #pragma region -- tape declaration --
+        /// Read only document laid out flat: one array of 64 bit entries(the tag in the high byte, the payload in the
+        /// rest) in the document order and one buffer of the string symbols. A container begin entry keeps the index
+        /// of its end entry and the number of its elements, so a container is stepped over at once; a string, an integer
+        /// and a floating point entry is followed by a second word(the length or the number bits). No allocation per
+        /// node, the views below are an index into the tape.
+        class tape
+        {
+        public:
+            /// The entry tags
+            enum tag : uint8_t
+            {
+                t_object_begin  = 0x7B, // {, the payload - the end index | the count << 32
+                t_object_end    = 0x7D, // }, the payload - the begin index
+                t_array_begin   = 0x5B, // [, the payload - the end index | the count << 32
+                t_array_end     = 0x5D, // ], the payload - the begin index
+                t_string        = 0x22, // ", the payload - the offset in the string buffer, the next word - the length
+                t_integer       = 0x6C, // l, the next word - the number
+                t_floatingpt    = 0x64, // d, the next word - the number bits
+                t_true          = 0x74, // t
+                t_false         = 0x66, // f
+                t_null          = 0x6E, // n
+                t_atom          = 0x61, // a, the payload - the intern_table::atom pointer
+            };
+
+            class obj_view;
+            class arr_view;
+
+            /// The view of a value on the tape
+            class value_view
+            {
+            public:
+                value_view(const tape* t, const size_t idx)
+                    : m_tape(t)
+                    , m_idx(idx)
+                {
+                }
+
+                typename value::vt index() const;
+
+                inline bool is_string()     const { return value::vt::t_string     == index(); }
+                inline bool is_object()     const { return value::vt::t_object     == index(); }
+                inline bool is_array()      const { return value::vt::t_array      == index(); }
+                inline bool is_integer()    const { return value::vt::t_integer    == index(); }
+                inline bool is_floatingpt() const { return value::vt::t_floatingpt == index(); }
+                inline bool is_number()     const { return is_integer() || is_floatingpt(); };
+                inline bool is_boolean()    const { return value::vt::t_boolean    == index(); }
+                inline bool is_null()       const { return value::vt::t_null       == index(); }
+
+                /// The object view, throws if not an object
+                obj_view object() const;
+
+                /// The array view, throws if not an array
+                arr_view array() const;
+
+                /// The member by the key, throws std::out_of_range if there is no such member
+                value_view operator[](const string_view& key) const;
+
+                /// The element by the index, throws std::out_of_range if there is no such element
+                value_view operator[](const size_t idx) const;
+
+                /// The string, valid as long as the tape(or the intern table), throws if not a string
+                string_view str() const;
+
+                /// The atom of the interned string, nullptr if the value is not one
+                const typename intern_table::atom* atom() const;
+
+                explicit operator string() const        { const string_view s = str(); return string(s.data(), s.size()); }
+                explicit operator int64_t() const;
+                explicit operator floatingpt_t() const;
+                explicit operator boolean_t() const;
+                explicit operator null_t() const;
+                explicit operator int32_t() const       { return (int32_t)(operator int64_t()); }
+                explicit operator int16_t() const       { return (int16_t)(operator int64_t()); }
+
+                /// The tree copy of the value
+                value to_value() const;
+
+                /// The index of the value entry on the tape
+                size_t position() const { return m_idx; }
+
+                /// The index of the entry following the value
+                size_t next() const;
+
+            protected:
+                const tape* m_tape;
+                size_t      m_idx;
+            };
+
+            /// The view of an object on the tape, the members are in the document order
+            class obj_view
+            {
+            public:
+                /// The member iterator
+                class iterator
+                {
+                public:
+                    iterator(const tape* t, const size_t idx) : m_tape(t), m_idx(idx) {}
+
+                    string_view key() const     { return value_view(m_tape, m_idx).str(); }
+                    value_view value() const    { return value_view(m_tape, value_view(m_tape, m_idx).next()); }
+
+                    /// The atom of the interned key, nullptr if the key is not interned
+                    const typename intern_table::atom* atom() const { return value_view(m_tape, m_idx).atom(); }
+
+                    iterator& operator++()      { m_idx = value().next(); return *this; }
+
+                    bool operator==(const iterator& other) const { return m_idx == other.m_idx; }
+                    bool operator!=(const iterator& other) const { return m_idx != other.m_idx; }
+
+                protected:
+                    const tape* m_tape;
+                    size_t      m_idx;  // the key entry
+                };
+
+                obj_view(const tape* t, const size_t idx) : m_tape(t), m_idx(idx) {}
+
+                iterator begin() const  { return iterator(m_tape, m_idx + 1); }
+                iterator end() const    { return iterator(m_tape, m_tape->end_of(m_idx)); }
+
+                size_t size() const;
+
+                /// The first member by the key, end() if there is no such member
+                iterator find(const string_view& key) const;
+
+                /// The first member by the atom of the interned key, the keys are compared by pointer
+                iterator find(const typename intern_table::atom* key) const;
+
+            protected:
+                const tape* m_tape;
+                size_t      m_idx;  // the begin entry
+            };
+
+            /// The view of an array on the tape
+            class arr_view
+            {
+            public:
+                /// The element iterator
+                class iterator
+                {
+                public:
+                    iterator(const tape* t, const size_t idx) : m_tape(t), m_idx(idx) {}
+
+                    value_view operator*() const { return value_view(m_tape, m_idx); }
+
+                    iterator& operator++()      { m_idx = value_view(m_tape, m_idx).next(); return *this; }
+
+                    bool operator==(const iterator& other) const { return m_idx == other.m_idx; }
+                    bool operator!=(const iterator& other) const { return m_idx != other.m_idx; }
+
+                protected:
+                    const tape* m_tape;
+                    size_t      m_idx;  // the element entry
+                };
+
+                arr_view(const tape* t, const size_t idx) : m_tape(t), m_idx(idx) {}
+
+                iterator begin() const  { return iterator(m_tape, m_idx + 1); }
+                iterator end() const    { return iterator(m_tape, m_tape->end_of(m_idx)); }
+
+                size_t size() const;
+
+            protected:
+                const tape* m_tape;
+                size_t      m_idx;  // the begin entry
+            };
+
+            tape() = default;
+
+            /// The tape interning the keys and the string values up to short_strings symbols to the table, the tapes
+            /// of the table share the atoms and keep no copies of them
+            explicit tape(intern_table& atoms, const size_t short_strings = 0)
+                : m_atoms(&atoms)
+                , m_short_strings(short_strings)
+            {
+            }
+
+            /// Parses the buffer [data, data + len) to the tape. max_depth - the nesting depth limit, 0 - no limit.
+            result_t parse(const symbol_t* data, const size_t len, const size_t max_depth = 0);
+
+            result_t parse(const string& input, const size_t max_depth = 0) { return parse(input.data(), input.size(), max_depth); }
+
+            /// Lays the tree out on the tape
+            void assign(const value& v);
+
+            /// The root value, the tape must not be empty
+            value_view root() const { return value_view(this, 0); }
+
+            /// Tells whether there is no document
+            boolean_t empty() const { return m_entries.empty(); }
+
+            /// The memory taken by the entries and the strings
+            size_t memory() const { return m_entries.capacity() * sizeof(uint64_t) + m_strings.capacity() * sizeof(symbol_t); }
+
+            /// The tag of the entry
+            tag tag_of(const size_t idx) const { return (tag)(m_entries[idx] >> 56); }
+
+            /// The payload of the entry
+            uint64_t payload_of(const size_t idx) const { return m_entries[idx] & 0x00FFFFFFFFFFFFFFull; }
+
+            /// The index of the end entry of the container beginning at idx
+            size_t end_of(const size_t idx) const { return (size_t)(payload_of(idx) & 0xFFFFFFFFull); }
+
+        protected:
+            /// flat_parser_t handler writing the tape
+            class builder_t
+            {
+            public:
+                static const bool borrows_strings = true;
+
+                explicit builder_t(tape& t)
+                    : m_tape(t)
+                {
+                }
+
+                result_t on_null()                              { return counted(), put(t_null); }
+                result_t on_boolean(const boolean_t b)          { return counted(), put(b ? t_true : t_false); }
+                result_t on_integer(const integer_t i);
+                result_t on_floatingpt(const floatingpt_t f);
+                result_t on_string_view(const string_view& str) { return counted(), put_string(str, false); }
+                result_t on_key_view(const string_view& key)    { return put_string(key, true); }
+                result_t on_string(string& str)                 { return counted(), put_string(string_view(str.data(), str.size()), false); }
+                result_t on_key(string& key)                    { return put_string(string_view(key.data(), key.size()), true); }
+                result_t on_object_begin()                      { return open(t_object_begin); }
+                result_t on_object_end()                        { return close(t_object_end); }
+                result_t on_array_begin()                       { return open(t_array_begin); }
+                result_t on_array_end()                         { return close(t_array_end); }
+
+                /// Writes the tree out
+                void replay(const value& v);
+
+            protected:
+                /// one more element of the enclosing container
+                void counted() { if (!m_counts.empty()) ++m_counts.back(); }
+
+                result_t put(const tag t, const uint64_t payload = 0);
+
+                /// The atom if the string is to be and can be interned, otherwise the copy in the string buffer
+                result_t put_string(const string_view& str, const boolean_t is_key);
+
+                result_t open(const tag t);
+
+                result_t close(const tag t);
+
+                tape&               m_tape;
+                vector_t<size_t>    m_open;     // the begin entries of the open containers
+                vector_t<size_t>    m_counts;   // the element counts of the open containers
+            };
+
+            vector_t<uint64_t>  m_entries;
+            vector_t<symbol_t>  m_strings;
+            intern_table*       m_atoms         = nullptr;
+            size_t              m_short_strings = 0;
+        };
+    #pragma endregion
+    //
+    #pragma region -- arena document declaration --
+        /// Document owning the arena its tree lives in(the configurations with AllocatorT = arena_allocator, see
+        /// arena_json). parse() builds the tree and the flat parser internals in the arena, the destruction and the
+        /// next parse() give the arena back at once without running the tree destructors. The tree is read only
+        /// outside, so nothing of it is moved out to dangle, and the changes below copy the given values into the
+        /// arena, so nothing of the heap ends up in the tree. A copy of root() is a tree of its own.
+        class arena_document
+        {
+            static_assert(std::is_same<allocator_t<symbol_t>, arena_allocator<symbol_t>>::value,
+                          "arena_document needs AllocatorT = arena_allocator");
+
+        public:
+            explicit arena_document(const size_t block_size = 64 * 1024, const bool huge_pages = false)
+                : m_arena(block_size, huge_pages)
+            {
+            }
+
+            arena_document(const arena_document&) = delete;
+            arena_document& operator=(const arena_document&) = delete;
+
+            /// Parses the buffer [data, data + len) by the flat engine. max_depth - the nesting depth limit, 0 - no limit.
+            result_t parse(const symbol_t* data, const size_t len, const size_t max_depth = 0);
+
+            /// The root value, null if nothing is parsed
+            const value& root() const { return *m_root; }
+
+            /// Replaces the root by the copy of the value
+            void assign(const value& v);
+
+            /// Sets the member of the root object to the copy of the value, throws if the root is not an object
+            void insert(const string& key, const value& v);
+
+            /// Appends the copy of the value to the root array, throws if the root is not an array
+            void push_back(const value& v);
+
+            /// The arena of the tree
+            const arena& get_arena() const { return m_arena; }
+
+        protected:
+            arena   m_arena;
+            value   m_null = value(null_t());
+            value*  m_root = &m_null;
+        };
+    #pragma endregion
+    //////////////////////////////////////////////////////////////////////////
+    };
+    //////////////////////////////////////////////////////////////////////////
+    using json = json_t<>;
+
+    /// The configuration allocating from the current arena(see arena_scope and json_t::arena_document)
+    using arena_json = json_t<char, int64_t, double, bool, nullptr_t, std::pair, std::less, std::char_traits, std::vector,
+                              std::list, std::map, std::basic_string, std::basic_stringstream, std::basic_istream,
+                              arena_allocator>;
+
+    /// The configuration with the objects on the sorted vectors(see flat_map)
+    using flat_json = json_t<char, int64_t, double, bool, nullptr_t, std::pair, std::less, std::char_traits, std::vector,
+                             std::list, flat_map>;
+
+    /// The configuration with the objects on the hash tables(see hash_map), the members are in the document order
+    using hash_json = json_t<char, int64_t, double, bool, nullptr_t, std::pair, std::less, std::char_traits, std::vector,
+                             std::list, hash_map>;
+
+#if _HAS_CXX17
+    /// The configuration on std::pmr, the trees are built in the resource of the current resource_scope
+    using pmr_json = json_t<char, int64_t, double, bool, nullptr_t, std::pair, std::less, std::char_traits, std::vector,
+                            std::list, std::map, std::basic_string, std::basic_stringstream, std::basic_istream,
+                            resource_allocator>;
+#endif
+    //////////////////////////////////////////////////////////////////////////
+    #pragma region -- json data definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::obj::obj(std::initializer_list<JSON_TEMPLATE_CLASS::pair_t<typename JSON_TEMPLATE_CLASS::string, typename JSON_TEMPLATE_CLASS::value>> l)
+    {
+        for (auto arg : l)
+            insert(arg);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    const typename JSON_TEMPLATE_CLASS::string
+    JSON_TEMPLATE_CLASS::obj::str(typename JSON_TEMPLATE_CLASS::sstream& str) const
+    {
+        // leading curly brace
+        str << "{";
+
+        for (auto it = begin(); it != end(); ++it)
+        {
+            const boolean_t last = (--end() == it);
+
+            // key
+            str << "\"" << it->first << "\":";
+
+            // value
+            switch ((value::vt)it->second.index())
+            {
+            case value::vt::t_string:
+                str << "\"" << container::serialize_string(it->second.get<string>()) << "\"";
+                break;
+            case value::vt::t_object:
+                it->second.get<obj>().str(str);
+                break;
+            case value::vt::t_array:
+                it->second.get<arr>().str(str);
+                break;
+            case value::vt::t_integer:
+                str << it->second.get<integer_t>();
+                break;
+            case value::vt::t_floatingpt:
+                str << std::scientific << it->second.get<floatingpt_t>();
+                break;
+            case value::vt::t_boolean:
+                str << (it->second.get<boolean_t>() ? "true" : "false");
+                break;
+            case value::vt::t_null:
+                str << "null";
+                break;
+            default: // unknown(i.e. not mentioned) type
+                assert(0);
+                break;
+            }
+
+            // comma if not the last one
+            str << (last ? "" : ",");
+        }
+
+        // trailing curly brace
+        str << "}";
+
+        return str.str();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::arr::arr(std::initializer_list<value> l)
+    {
+        for (auto arg : l)
+            push_back(arg);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    const typename JSON_TEMPLATE_CLASS::string
+    JSON_TEMPLATE_CLASS::arr::str(typename JSON_TEMPLATE_CLASS::sstream& str) const
+    {
+        // leading curly brace
+        str << "[";
+
+        for (auto it = begin(); it != end(); ++it)
+        {
+            const boolean_t last = (--end() == it);
+
+            // value
+            switch ((value::vt)it->index())
+            {
+            case value::vt::t_string:
+                str << "\"" << container::serialize_string((*it).get<string>())<< "\"";
+                break;
+            case value::vt::t_object:
+                (*it).get<obj>().str(str);
+                break;
+            case value::vt::t_array:
+                (*it).get<arr>().str(str);
+                break;
+            case value::vt::t_integer:
+                str << (*it).get<integer_t>();
+                break;
+            case value::vt::t_floatingpt:
+                str << std::scientific << (*it).get<floatingpt_t>();
+                break;
+            case value::vt::t_boolean:
+                str << (((*it).get<boolean_t>() ? "true" : "false"));
+                break;
+            case value::vt::t_null:
+                str << "null";
+                break;
+            default:
+                assert(0);
+                break;
+            }
+
+            // comma if not the last one
+            str << (last ? "" : ",");
+        }
+
+        // trailing curly brace
+        str << "]";
+
+        return str.str();
+    }
+    #pragma endregion
+    //
+    #pragma region -- string parser definition --
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::string_parser_t::reset()
+    {
+        state::set(state_t::initial);
+        m_value.reset();
+        m_cache.clear();
+        m_surrogate = 0;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        return parser_impl::step(to_event(c), c, pos);
+    };
+
+    JSON_TEMPLATE_PARAMS
+    size_t
+    JSON_TEMPLATE_CLASS::string_parser_t::putrun(const symbol_t* data, const size_t len, const pos_t pos)
+    {
+        if (state_t::inside != state::get())
+            return 0;
+
+        const size_t run = plain_run(data, len);
+        if (0 != run)
+        {
+            if (!m_value)
+                m_value.emplace();
+
+            (*m_value).append(data, run);
+        }
+
+        return run;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::string_parser_t::get() const
+    {
+        if (m_value)
+            return *m_value;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::string_parser_t::take()
+    {
+        if (m_value)
+            return value(std::move(*m_value));
+
+        throw std::logic_error("No value.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::string_parser_t::event_t
+    JSON_TEMPLATE_CLASS::string_parser_t::to_event(const symbol_t& c) const
+    {
+        event_t smb = event_t::symbol;
+        switch (state::get())
+        {
+        case state_t::initial:
+            if (0x22 == c)
+                smb = event_t::quote;
+            break;
+        case state_t::inside:
+            if (0x5C == c)
+                smb = event_t::back_slash;
+            if (0x22 == c)
+                smb = event_t::quote;
+            break;
+        case state_t::escape:
+            switch (c)
+            {
+            case 0x22:  smb = event_t::quote;       break;
+            case 0x5C:  smb = event_t::back_slash;  break;
+            case 0x2F:  smb = event_t::slash;       break;
+            case 0x62:  smb = event_t::alpha_b;     break;
+            case 0x66:  smb = event_t::alpha_f;     break;
+            case 0x6E:  smb = event_t::alpha_n;     break;
+            case 0x72:  smb = event_t::alpha_r;     break;
+            case 0x74:  smb = event_t::alpha_t;     break;
+            case 0x75:  smb = event_t::alpha_u;     break;
+            }
+            break;
+        case state_t::unicode_1:
+        case state_t::unicode_2:
+        case state_t::unicode_3:
+        case state_t::unicode_4:
+            if (0x30 <= c && c <= 0x39)
+                smb = event_t::hex_digit;
+            if (0x41 <= c && c <= 0x46)
+                smb = event_t::hex_digit;
+            if (0x61 <= c && c <= 0x66)
+                smb = event_t::hex_digit;
+            break;
+        case state_t::done:
+            assert(0);
+            break;
+        }
+
+        return smb;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::string_parser_t::event_t
+    JSON_TEMPLATE_CLASS::string_parser_t::to_event(const result_t& c) const
+    {
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_initial(const symbol_t&c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_inside(const symbol_t&c, const pos_t pos)
+    {
+        if (!m_value)
+            m_value.emplace();
+
+        (*m_value) += c;
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_escape(const symbol_t&c, const pos_t pos)
+    {
+        // the back slash itself
+        if (state_t::inside == state::get())
+            return result_t::s_need_more;
+
+        const uint8_t symbol = detail::unescape((uint32_t)c);
+        if (0 == symbol)
+            return result_t::e_unexpected;
+
+        if (!m_value)
+            m_value.emplace();
+
+        (*m_value) += (symbol_t)symbol;
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_unicode(const symbol_t&c, const pos_t pos)
+    {
+        switch (state::get())
+        {
+        case state_t::escape:       // the 'u' symbol
+            m_cache.clear();
+            break;
+        case state_t::unicode_1:
+        case state_t::unicode_2:
+        case state_t::unicode_3:
+            m_cache.push_back(c);
+            break;
+        case state_t::unicode_4:
+        {
+            m_cache.push_back(c);
+
+            uint32_t cu = 0;
+            for (const symbol_t& h : m_cache)
+                cu = (cu << 4) | (uint32_t)detail::hex_value((uint32_t)h);
+            m_cache.clear();
+
+            if (!m_value)
+                m_value.emplace();
+
+            // the low surrogate right after the high one - replace the latter by the whole pair
+            if (1 == sizeof(symbol_t) && 0xDC00 <= cu && cu <= 0xDFFF && 0 != m_surrogate && (*m_value).size() == m_surrogate_end)
+            {
+                (*m_value).resize(m_surrogate_end - 3);
+                cu = 0x10000 + ((m_surrogate - 0xD800) << 10) + (cu - 0xDC00);
+            }
+
+            m_surrogate = (0xD800 <= cu && cu <= 0xDBFF) ? cu : 0;
+
+            append_code_point(*m_value, cu);
+            m_surrogate_end = (*m_value).size();
+            break;
+        }
+        default:
+            return result_t::e_unexpected;
+        }
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_done(const symbol_t&c, const pos_t pos)
+    {
+        if (!m_value)
+            m_value.emplace();
+
+        return result_t::s_done;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::string_parser_t::on_fail(const symbol_t&c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+    #pragma endregion
+    //
+    #pragma region -- number parser definition --
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::number_parser_t::reset()
+    {
+        state::set(state_t::initial);
+
+        m_value.reset();
+        m_converted = value();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        return parser_impl::step(to_event(c), c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::number_parser_t::get() const
+    {
+        if (m_value)
+            return m_converted;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::number_parser_t::take()
+    {
+        if (m_value)
+            return std::move(m_converted);
+
+        throw std::logic_error("No value.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::number::integer_digit(const uint32_t d)
+    {
+        if (m_digits < max_digits)
+        {
+            m_significand = m_significand * 10 + d;
+            if (0 != m_significand)
+                ++m_digits;
+        }
+        else
+        {
+            ++m_scale;
+            tail_digit(d);
+        }
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::number::fractional_digit(const uint32_t d)
+    {
+        m_is_float = true;
+
+        if (m_digits < max_digits)
+        {
+            // the leading zeros of the fraction are not significant, they only move the scale
+            m_significand = m_significand * 10 + d;
+            if (0 != m_significand)
+                ++m_digits;
+            --m_scale;
+        }
+        else
+        {
+            tail_digit(d);
+        }
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::number::exponent_digit(const uint32_t d)
+    {
+        m_is_float = true;
+
+        if (m_exponent_value < max_exponent)
+            m_exponent_value = m_exponent_value * 10 + (int32_t)d;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::number::tail_digit(const uint32_t d)
+    {
+        if (m_tail.size() < max_tail)
+            m_tail.push_back((char)(0x30 + d));
+        else if (0 != d && '0' == m_tail.back())
+            m_tail.back() = '1'; // keeps the sign of the remainder, that is all the rounding needs
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::number::to_value() const
+    {
+        if (!m_is_float && 0 == m_scale)
+        {
+            const uint64_t limit = (uint64_t)std::numeric_limits<integer_t>::max() + (m_positive ? 0 : 1);
+            if (m_significand <= limit)
+                return value(m_positive ? (integer_t)m_significand : (integer_t)(0 - m_significand));
+            // does not fit integer_t, goes as floating point
+        }
+
+        const int64_t exp10 = (int64_t)m_scale + (m_exponent_positive ? m_exponent_value : -m_exponent_value);
+
+        floatingpt_t result = 0;
+        if (0 == m_significand)
+        {
+            result = 0;
+        }
+        else if (m_tail.empty() && m_significand <= (1ull << 53) && -22 <= exp10 && exp10 <= 22)
+        {
+            // Clinger's fast path: both operands are exact doubles, the single operation is correctly rounded
+            const double s = (double)m_significand;
+            result = (floatingpt_t)(exp10 < 0 ? s / detail::exact_pow10((int32_t)-exp10) : s * detail::exact_pow10((int32_t)exp10));
+        }
+        else if (m_tail.empty() && 22 < exp10 && exp10 <= 22 + 15 &&
+                 m_significand <= (1ull << 53) / (uint64_t)detail::exact_pow10((int32_t)(exp10 - 22)))
+        {
+            // the excess of the exponent goes to the significand while it stays exact
+            const double s = (double)(m_significand * (uint64_t)detail::exact_pow10((int32_t)(exp10 - 22)));
+            result = (floatingpt_t)(s * detail::exact_pow10(22));
+        }
+        else
+        {
+            // Eisel-Lemire, the dropped digits put the number between the significand and the next one: both have to
+            // round the same. The rest goes to the slow path.
+            double lower = 0, upper = 0;
+            if (detail::eisel_lemire(exp10, m_significand, lower) &&
+                (m_tail.empty() || (detail::eisel_lemire(exp10, m_significand + 1, upper) && lower == upper)))
+                result = (floatingpt_t)lower;
+            else
+                result = to_floatingpt_slow(exp10);
+        }
+
+        return value(m_positive ? result : -result);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::floatingpt_t
+    JSON_TEMPLATE_CLASS::number::to_floatingpt_slow(const int64_t exp10) const
+    {
+        // digits and the exponent only, no decimal point, so the locale does not matter
+        char head[48];
+        char* p = head + 20;
+        for (uint64_t s = m_significand; 0 != s; s /= 10)
+            *--p = (char)(0x30 + s % 10);
+
+        if (m_tail.empty())
+        {
+            snprintf(head + 20, sizeof(head) - 20, "e%lld", (long long)exp10);
+            return (floatingpt_t)std::strtod(p, nullptr);
+        }
+
+        std::string text(p, head + 20);
+        text += m_tail;
+        text += 'e';
+        text += std::to_string(exp10 - (int64_t)m_tail.size());
+
+        return (floatingpt_t)std::strtod(text.c_str(), nullptr);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::number_parser_t::event_t
+    JSON_TEMPLATE_CLASS::number_parser_t::to_event(const symbol_t& c) const
+    {
+        if (0x2D == c)
+            return event_t::minus;
+        if (0x2B == c)
+            return event_t::plus;
+        if (0x30 == c)
+            return event_t::dec_zero;
+        if (0x2E == c)
+            return event_t::dot;
+        if (0x45 == c || 0x65 == c)
+            return event_t::exponent;
+        if (0x31 <= c && c <= 0x39)
+            return event_t::dec_digit;
+
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::number_parser_t::event_t
+    JSON_TEMPLATE_CLASS::number_parser_t::to_event(const result_t& c) const
+    {
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_initial(const symbol_t& c, const pos_t pos)
+    {
+        // TODO: use symbol
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_minus(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_value)
+            m_value.emplace();
+
+        (*m_value).m_positive = false;
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_integer(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_value)
+            m_value.emplace();
+
+        (*m_value).integer_digit((uint32_t)(c - 0x30));
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_fractional(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+        (*m_value).fractional_digit((uint32_t)(c - 0x30));
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_exponent(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+        (*m_value).m_is_float = true;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_exp_sign(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+
+        switch (c)
+        {
+        case 0x2D:
+            (*m_value).m_exponent_positive = false; break;
+        case 0x2B:
+            (*m_value).m_exponent_positive = true; break;
+        default:
+            return result_t::e_fatal;
+        }
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_exp_value(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+        (*m_value).exponent_digit((uint32_t)(c - 0x30));
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_zero(const symbol_t& c, const pos_t pos)
+    {
+
+        const state_t s = state::get();
+
+        switch (s)
+        {
+        case state_t::initial:
+        case state_t::leading_minus:
+        case state_t::integer:
+            if (!m_value)
+                m_value.emplace();
+            (*m_value).integer_digit(0);
+            break;
+        case state_t::decimal_dot:
+        case state_t::fractional:
+            assert(m_value);
+            (*m_value).fractional_digit(0);
+            break;
+        case state_t::exponent_delim:
+        case state_t::exponent_sign:
+        case state_t::exponent_val:
+            assert(m_value);
+            (*m_value).exponent_digit(0);
+            break;
+        }
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_dot(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+        m_converted = (*m_value).to_value();
+        return result_t::s_done_rpt;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::number_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+    #pragma endregion
+    //
+    #pragma region -- null parser definition -- 
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::null_parser_t::reset()
+    {
+        state::set(state_t::initial);
+        m_value.reset();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        return parser_impl::step(to_event(c), c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::null_parser_t::get() const
+    {
+        if (m_value)
+            return *m_value;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::null_parser_t::event_t
+    JSON_TEMPLATE_CLASS::null_parser_t::to_event(const symbol_t& c) const
+    {
+        switch (c)
+        {
+        case 0x6e:
+            return event_t::letter_n;
+        case 0x75:
+            return event_t::letter_u;
+        case 0x6c:
+            return event_t::letter_l;
+        }
+
+        return event_t::other;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::null_parser_t::event_t
+    JSON_TEMPLATE_CLASS::null_parser_t::to_event(const result_t& c) const
+    {
+        return event_t::other;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::on_n(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::on_u(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::on_l(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_value)
+            m_value.emplace();
+
+        (*m_value) = nullptr;
+
+        return result_t::s_done;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::null_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+    #pragma endregion
+    //
+    #pragma region -- bool parser definition -- 
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::bool_parser_t::reset()
+    {
+        state::set(state_t::initial);
+        m_str.clear();
+        m_value.reset();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        return parser_impl::step(to_event(c), c, pos);
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::bool_parser_t::get() const
+    {
+        if (m_value)
+            return *m_value;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::bool_parser_t::event_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::to_event(const symbol_t& c) const
+    {
+        switch (c)
+        {
+        case 0x61:
+            return event_t::letter_a;
+        case 0x65:
+            return event_t::letter_e;
+        case 0x66:
+            return event_t::letter_f;
+        case 0x6c:
+            return event_t::letter_l;
+        case 0x72:
+            return event_t::letter_r;
+        case 0x73:
+            return event_t::letter_s;
+        case 0x74:
+            return event_t::letter_t;
+        case 0x75:
+            return event_t::letter_u;
+        }
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::bool_parser_t::event_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::to_event(const result_t& c) const
+    {
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_t(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_r(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_u(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_f(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_a(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_l(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_s(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        m_str += c;
+
+        auto update = [this](const boolean_t val)->result_t 
+        {
+            if (!m_value)
+                m_value.emplace();
+
+            (*m_value) = val;
+
+            return result_t::s_done;
+        };
+
+        if (m_str == "true")
+            return update(true);
+        if (m_str == "false")
+            return update(false);
+
+        assert(0);
+
+        return result_t::e_unexpected;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::bool_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+    #pragma endregion
+    //
+    #pragma region -- value parser definition --
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::value_parser_t::reset()
+    {
+        state::set(state_t::initial);
+        if (m_active)
+            m_active->reset(), m_active = nullptr;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::value_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        result_t r = parser_impl::step(to_event(c), c, pos);
+
+        if (state::get() == state_t::read && (result_t::s_done == r || result_t::s_done_rpt == r))
+        {
+            result_t new_r = parser_impl::step(to_event(r), c, pos);
+            assert(result_t::s_done == new_r);
+            return  r != new_r ? r : new_r;
+        }
+
+        return r;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    size_t
+    JSON_TEMPLATE_CLASS::value_parser_t::putrun(const symbol_t* data, const size_t len, const pos_t pos)
+    {
+        if (state_t::read != state::get() || !m_active)
+            return 0;
+
+        return m_active->putrun(data, len, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::value_parser_t::get() const
+    {
+        if (m_active)
+            return m_active->get();
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::value_parser_t::take()
+    {
+        if (m_active)
+            return m_active->take();
+
+        throw std::logic_error("No value.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value_parser_t::event_t
+    JSON_TEMPLATE_CLASS::value_parser_t::to_event(const symbol_t& c) const
+    {
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value_parser_t::event_t
+    JSON_TEMPLATE_CLASS::value_parser_t::to_event(const result_t& c) const
+    {
+        switch (state::get())
+        {
+        case state_t::read:
+            if (result_t::s_done == c || result_t::s_done_rpt == c)
+                return event_t::val_done;
+            break;
+        }
+
+        return event_t::nothing;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::value_parser_t::on_data(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_active)
+        {
+            if (is_space(c))
+                return result_t::s_need_more;
+
+            const kind_t kind = detail::kind_of((uint32_t)c);
+            if (kind_t::none == kind)
+                return result_t::e_unexpected;
+
+            typename parser::ptr& p = m_parsers[(size_t)kind];
+            if (!p)
+                p.reset(create(kind));
+
+            m_active = p.get();
+        }
+
+        return m_active->putchar(c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::value_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_done;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::value_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::parser*
+    JSON_TEMPLATE_CLASS::value_parser_t::create(const kind_t kind)
+    {
+        switch (kind)
+        {
+        case kind_t::null:      return new null_parser_t();
+        case kind_t::boolean:   return new bool_parser_t();
+        case kind_t::string:    return new string_parser_t();
+        case kind_t::number:    return new number_parser_t();
+        case kind_t::array:     return new array_parser_t();
+        case kind_t::object:    return new object_parser_t();
+        }
+
+        assert(0);
+        return nullptr;
+    }
+    #pragma endregion
+    //
+    #pragma region -- array parser definition -- 
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::array_parser_t::reset()
+    {
+        state::set(state_t::initial);
+
+        if (!m_val_parser)
+            m_val_parser.reset(new value_parser_t());
+
+        m_val_parser->reset();
+
+        m_value.reset();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        result_t r = parser_impl::step(to_event(c), c, pos);
+
+        event_t e = to_event(r);
+
+        if (event_t::nothing == e)
+            return r;
+
+        if (event_t::val_done == e)
+        {
+            result_t new_r = parser_impl::step(e, c, pos);
+            r = result_t::s_need_more == new_r && result_t::s_done_rpt == r ?
+                parser_impl::step(to_event(c), c, pos) :
+                new_r;
+
+            return r;
+        }
+
+        assert(0);
+
+        return r;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    size_t
+    JSON_TEMPLATE_CLASS::array_parser_t::putrun(const symbol_t* data, const size_t len, const pos_t pos)
+    {
+        return state_t::val_inside == state::get() ? m_val_parser->putrun(data, len, pos) : 0;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::array_parser_t::get() const
+    {
+        if (m_value)
+            return *m_value;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::array_parser_t::take()
+    {
+        if (m_value)
+            return value(std::move(*m_value));
+
+        throw std::logic_error("No value.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::array_parser_t::event_t
+    JSON_TEMPLATE_CLASS::array_parser_t::to_event(const symbol_t& c) const
+    {
+        auto is_space = [](const symbol_t& c)->boolean_t
+        {
+            // space, tab, cr, lf
+            return (0x20 == c || 0x09 == c || 0x0A == c || 0x0D == c);
+        };
+
+        switch (state::get())
+        {
+        case state_t::initial:
+            if (0x5B == c) //[
+                return event_t::arr_begin;
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        case state_t::val_before:
+            if (0x5D == c) //]
+                return event_t::arr_end;
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        case state_t::val_after:
+            if (0x5D == c) //]
+                return event_t::arr_end;
+            if (0x2C == c) //,
+                return event_t::comma;
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        }
+
+        return event_t::symbol;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::array_parser_t::event_t
+    JSON_TEMPLATE_CLASS::array_parser_t::to_event(const result_t& r) const
+    {
+        switch (state::get())
+        {
+        case state_t::val_inside:
+            if (result_t::s_done == r || result_t::s_done_rpt == r)
+                return event_t::val_done;
+            break;
+        }
+
+        return event_t::nothing;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_more(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_begin(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_val_parser)
+            m_val_parser.reset(new value_parser_t());
+
+        if (!m_value)
+            m_value.emplace();
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_new(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_val(const symbol_t& c, const pos_t pos)
+    {
+        return m_val_parser->putchar(c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_got_val(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+
+        (*m_value).push_back(m_val_parser->take());
+
+        m_val_parser->reset();
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+
+        return result_t::s_done;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::array_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::e_unexpected;
+    }
+    #pragma endregion
+    //
+    #pragma region -- object parser definition --
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::object_parser_t::reset()
+    {
+        state::set(state_t::initial);
+
+        if (!m_key_parser)
+            m_key_parser.reset(new string_parser_t());
+        else
+            m_key_parser->reset();
+
+        if (!m_val_parser)
+            m_val_parser.reset(new value_parser_t());
+        else
+            m_val_parser->reset();
+
+        m_value.reset();
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::putchar(const symbol_t& c, const pos_t pos)
+    {
+        result_t r = parser_impl::step(to_event(c), c, pos);
+
+        event_t e = to_event(r);
+
+        if (event_t::nothing == e)
+            return r;
+
+        if (event_t::val_done == e || event_t::key_done == e)
+        {
+            result_t new_r = parser_impl::step(e, c, pos);
+            r = result_t::s_need_more == new_r && result_t::s_done_rpt == r ?
+                parser_impl::step(to_event(c), c, pos) :
+                new_r;
+
+            return r;
+        }
+
+        assert(0); // TODO: throw an exception
+
+        return r;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    size_t
+    JSON_TEMPLATE_CLASS::object_parser_t::putrun(const symbol_t* data, const size_t len, const pos_t pos)
+    {
+        switch (state::get())
+        {
+        case state_t::key_inside:
+            return m_key_parser->putrun(data, len, pos);
+        case state_t::val_inside:
+            return m_val_parser->putrun(data, len, pos);
+        }
+
+        return 0;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::object_parser_t::get() const
+    {
+        if (m_value)
+            return *m_value;
+
+        assert(0); // TODO: throw an exception
+        return value();
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::object_parser_t::take()
+    {
+        if (m_value)
+            return value(std::move(*m_value));
+
+        throw std::logic_error("No value.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::object_parser_t::event_t
+    JSON_TEMPLATE_CLASS::object_parser_t::to_event(const symbol_t& c) const
+    {
+        auto is_space = [](const symbol_t& c)->boolean_t
+        {
+            // space, tab, cr, lf
+            return (0x20 == c || 0x09 == c || 0x0A == c || 0x0D == c);
+        };
+
+        switch (state::get())
+        {
+        case state_t::initial:
+            if (0x7B == c)  //{
+                return event_t::obj_begin;
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        case state_t::key_before:
+            if (0x7D == c)  //}
+                return event_t::obj_end;
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        case state_t::key_after:
+            if (is_space(c))
+                return event_t::skip;
+            if (0x3A == c)  //:
+                return event_t::colon;
+            break;
+        case state_t::val_before:
+            if (is_space(c))
+                return event_t::skip;
+            break;
+        case state_t::val_after:
+            if (0x7D == c)  //}
+                return event_t::obj_end;
+            if (is_space(c))
+                return event_t::skip;
+            if (0x2c == c)  //,
+                return event_t::comma;
+            break;
+        }
+
+        return event_t::symbol;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::object_parser_t::event_t
+    JSON_TEMPLATE_CLASS::object_parser_t::to_event(const result_t& r) const
+    {
+        switch (state::get())
+        {
+        case state_t::key_inside:
+            if (result_t::s_done == r)
+                return event_t::key_done;
+            break;
+        case state_t::val_inside:
+            if (result_t::s_done == r || result_t::s_done_rpt == r)
+                return event_t::val_done;
+            break;
+        }
+
+        return event_t::nothing;
+    };
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_more(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_begin(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_key_parser)
+            m_key_parser.reset(new string_parser_t());
+
+        if (!m_val_parser)
+            m_val_parser.reset(new value_parser_t());
+
+        if (!m_value)
+            m_value.emplace();
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_new(const symbol_t& c, const pos_t pos)
+    {
+        if (!m_key_parser)
+            m_key_parser.reset(new string_parser_t());
+        else
+            m_key_parser->reset();
+
+        if (!m_val_parser)
+            m_val_parser.reset(new value_parser_t());
+        else
+            m_val_parser->reset();
+
+        return result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_key(const symbol_t& c, const pos_t pos)
+    {
+        return m_key_parser->putchar(c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_val(const symbol_t& c, const pos_t pos)
+    {
+        return m_val_parser->putchar(c, pos);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_done(const symbol_t& c, const pos_t pos)
+    {
+        return result_t::s_done;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_fail(const symbol_t& c, const pos_t pos)
+    {
+        m_value.reset();
+        return result_t::e_unexpected;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::object_parser_t::on_got_val(const symbol_t& c, const pos_t pos)
+    {
+        assert(m_value);
+
+        string key = m_key_parser->take().take<string>();
+
+        (*m_value)[std::move(key)] = m_val_parser->take();
+
+        return result_t::s_need_more;
+    }
+#pragma endregion
+    //
+    #pragma region -- session definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::session::session(typename parser::ptr root)
+        : m_root(root)
+    {
+        assert(m_root);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::session::reset()
+    {
+        m_root->reset();
+
+        m_consumed  = 0;
+        m_pos       = 0;
+        m_started   = false;
+        m_result    = result_t::s_need_more;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::session::limit(const size_t max_symbols)
+    {
+        m_limit = max_symbols;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::session::feed(const symbol_t* data, const size_t len)
+    {
+        m_consumed = 0;
+
+        if (result_t::s_need_more != m_result)
+            return m_result;
+
+        const size_t count = (0 != m_limit && m_limit < len) ? m_limit : len;
+
+        while (m_consumed < count)
+        {
+            const symbol_t& c = data[m_consumed];
+
+            // leading whitespaces make no sense to the root parser
+            if (!m_started && is_space(c))
+            {
+                ++m_consumed, ++m_pos;
+                continue;
+            }
+
+            m_started = true;
+
+            // the run of symbols the parser takes at once(i.e. the plain part of a string)
+            const size_t run = m_root->putrun(data + m_consumed, count - m_consumed, m_pos);
+            if (0 != run)
+            {
+                m_consumed += run, m_pos += (pos_t)run;
+                continue;
+            }
+
+            m_result = m_root->putchar(c, m_pos);
+
+            if (failed(m_result))
+                break;
+
+            if (result_t::s_done == m_result)
+            {
+                ++m_consumed, ++m_pos;
+                break;
+            }
+
+            if (result_t::s_done_rpt == m_result)
+            {
+                // the symbol terminates the value but does not belong to it
+                m_result = result_t::s_done;
+                break;
+            }
+
+            ++m_consumed, ++m_pos;
+        }
+
+        return m_result;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::session::finish()
+    {
+        if (result_t::s_need_more != m_result || !m_started)
+            return m_result;
+
+        // the end of data terminates the pending token the same way a whitespace does
+        m_result = m_root->putchar(0x20, m_pos);
+
+        if (result_t::s_done_rpt == m_result)
+            m_result = result_t::s_done;
+
+        return m_result;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::session::parse(const symbol_t* data, const size_t len)
+    {
+        const result_t result = feed(data, len);
+
+        return result_t::s_need_more == result && m_consumed == len ? finish() : result;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::session::get() const
+    {
+        if (result_t::s_done == m_result)
+            return m_root->get();
+
+        throw std::logic_error("The value is not complete.");
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::session::take()
+    {
+        if (result_t::s_done == m_result)
+            return m_root->take();
+
+        throw std::logic_error("The value is not complete.");
+    }
+    #pragma endregion
+    //
+    #pragma region -- parse context definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::parse_context::parse_context()
+        : m_value_session(create_value())
+        , m_object_session(create())
+    {
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::parse_context::parse(const symbol_t* begin, const size_t len, value& jsval)
+    {
+        m_value_session.reset();
+
+        const result_t result = m_value_session.parse(begin, len);
+        if (result_t::s_done == result)
+            jsval = m_value_session.take();
+
+        return result;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::parse_context::parse(const symbol_t* begin, const size_t len, obj& jsobj)
+    {
+        m_object_session.reset();
+
+        const result_t result = m_object_session.parse(begin, len);
+        if (result_t::s_done == result)
+            jsobj = m_object_session.take().take<obj>();
+
+        return result;
+    }
+    #pragma endregion
+    //
+    #pragma region -- document reader definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::document_reader::document_reader(istream& input, const size_t chunk_size)
+        : m_input(&input)
+        , m_chunk(0 != chunk_size ? chunk_size : 1)
+    {
+    }
+
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::document_reader::document_reader(const symbol_t* data, const size_t len)
+        : m_data(data)
+        , m_len(len)
+    {
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::boolean_t
+    JSON_TEMPLATE_CLASS::document_reader::fill()
+    {
+        if (!m_input || !m_input->good())
+            return false;
+
+        m_input->read(m_chunk.data(), (std::streamsize)m_chunk.size());
+
+        m_data   = m_chunk.data();
+        m_len    = (size_t)m_input->gcount();
+        m_offset = 0;
+
+        return 0 != m_len;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::document_reader::next(value& jsval)
+    {
+        for (;;)
+        {
+            if (m_offset == m_len && !fill())
+            {
+                // the end of the input terminates the pending root value(i.e. a number)
+                if (m_skip || !m_session.started())
+                    return result_t::s_ok;
+
+                const result_t result = m_session.finish();
+                if (result_t::s_done == result)
+                    jsval = m_session.take(), ++m_count;
+
+                m_session.reset();
+                return result;
+            }
+
+            if (m_skip)
+            {
+                while (m_offset < m_len && 0x0A != m_data[m_offset] && 0x1E != m_data[m_offset])
+                    ++m_offset;
+
+                if (m_offset < m_len)
+                    m_skip = false;
+
+                continue;
+            }
+
+            if (!m_session.started())
+            {
+                // the separators of the documents
+                while (m_offset < m_len && (is_space(m_data[m_offset]) || 0x1E == m_data[m_offset]))
+                    ++m_offset;
+
+                if (m_offset == m_len)
+                    continue;
+            }
+
+            const result_t result = m_session.feed(m_data + m_offset, m_len - m_offset);
+            m_offset += m_session.consumed();
+
+            if (result_t::s_done == result)
+            {
+                jsval = m_session.take(), ++m_count;
+                m_session.reset();
+                return result;
+            }
+
+            if (failed(result))
+            {
+                m_session.reset();
+                m_skip = true;
+                return result;
+            }
+        }
+    }
+    #pragma endregion
+    //
+    #pragma region -- pull reader definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::reader::reader(istream& input, const size_t chunk_size)
+        : m_input(&input)
+        , m_chunk(0 != chunk_size ? chunk_size : 1)
+        , m_chunk_size(0 != chunk_size ? chunk_size : 1)
+    {
+        m_stack.reserve(64);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::reader::reader(const symbol_t* data, const size_t len)
+        : m_data(data)
+        , m_len(len)
+    {
+        m_stack.reserve(64);
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::boolean_t
+    JSON_TEMPLATE_CLASS::reader::fill()
+    {
+        if (!m_input || !m_input->good())
+            return false;
+
+        const size_t rest = m_len - m_pos;
+
+        // the token does not fit the chunk
+        if (rest + m_chunk_size > m_chunk.size())
+        {
+            vector_t<symbol_t> chunk(rest + m_chunk_size);
+            std::copy(m_data + m_pos, m_data + m_len, chunk.data());
+            m_chunk.swap(chunk);
+        }
+        else if (0 != m_pos)
+        {
+            memmove(m_chunk.data(), m_data + m_pos, rest * sizeof(symbol_t));
+        }
+
+        m_input->read(m_chunk.data() + rest, (std::streamsize)m_chunk_size);
+
+        m_data  = m_chunk.data();
+        m_len   = rest + (size_t)m_input->gcount();
+        m_pos   = 0;
+
+        return rest != m_len;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::token_t
+    JSON_TEMPLATE_CLASS::reader::next()
+    {
+        if (token_t::error == m_token)
+            return m_token;
+
+        for (;;)
+        {
+            while (m_pos < m_len && is_space(m_data[m_pos]))
+                ++m_pos;
+
+            if (m_pos == m_len)
+            {
+                if (fill())
+                    continue;
+
+                if (expect::value == m_expect && m_stack.empty())
+                    return m_token = token_t::end;
+
+                return fail(result_t::s_need_more);
+            }
+
+            const symbol_t c = m_data[m_pos];
+            result_t r = result_t::s_ok;
+
+            switch (m_expect)
+            {
+            case expect::first_value_or_end:
+                if (0x5D == c) // ]
+                {
+                    m_stack.pop_back(), ++m_pos;
+                    after_value();
+                    return m_token = token_t::array_end;
+                }
+                // no break
+            case expect::value:
+                switch (c)
+                {
+                case 0x7B: // {
+                    m_stack.push_back(true), ++m_pos;
+                    m_expect = expect::first_key_or_end;
+                    return m_token = token_t::object_begin;
+                case 0x5B: // [
+                    m_stack.push_back(false), ++m_pos;
+                    m_expect = expect::first_value_or_end;
+                    return m_token = token_t::array_begin;
+                case 0x22: // "
+                    if (result_t::s_ok != (r = scan_string()))
+                        return fail(r);
+
+                    after_value();
+                    return m_token = token_t::string;
+                default:
+                    if (result_t::s_ok != (r = scan_scalar()))
+                        return fail(r);
+
+                    after_value();
+                    switch (m_scalar.index())
+                    {
+                    case value::vt::t_integer:
+                        return m_token = token_t::integer;
+                    case value::vt::t_floatingpt:
+                        return m_token = token_t::floatingpt;
+                    case value::vt::t_boolean:
+                        return m_token = token_t::boolean;
+                    default:
+                        return m_token = token_t::null;
+                    }
+                }
+            case expect::first_key_or_end:
+                if (0x7D == c) // }
+                {
+                    m_stack.pop_back(), ++m_pos;
+                    after_value();
+                    return m_token = token_t::object_end;
+                }
+                // no break
+            case expect::key:
+                if (0x22 != c)
+                    return fail(result_t::e_unexpected);
+
+                if (result_t::s_ok != (r = scan_string()))
+                    return fail(r);
+
+                m_expect = expect::colon;
+                return m_token = token_t::key;
+            case expect::colon:
+                if (0x3A != c)
+                    return fail(result_t::e_unexpected);
+
+                ++m_pos;
+                m_expect = expect::value;
+                break;
+            case expect::comma_or_end:
+                if (0x2C == c) // ,
+                {
+                    ++m_pos;
+                    m_expect = m_stack.back() ? expect::key : expect::value;
+                    break;
+                }
 
-            result_t on_fail(const symbol_t& c, const int pos);
+                if ((m_stack.back() ? 0x7D : 0x5D) != c)
+                    return fail(result_t::e_unexpected);
 
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
+                {
+                    const boolean_t is_object = m_stack.back();
+                    m_stack.pop_back(), ++m_pos;
+                    after_value();
+                    return m_token = is_object ? token_t::object_end : token_t::array_end;
+                }
+            }
+        }
+    }
 
-            typename parser::ptr m_val_parser;
-        };
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::reader::skip()
+    {
+        if (token_t::key == m_token && token_t::error == next())
+            return m_result;
+
+        if (token_t::object_begin != m_token && token_t::array_begin != m_token)
+            return token_t::error == m_token ? m_result : result_t::s_ok;
+
+        size_t depth = 1;
+        while (0 != depth)
+        {
+            if (m_pos == m_len && !fill())
+                return fail(result_t::s_need_more), m_result;
+
+            switch (m_data[m_pos])
+            {
+            case 0x22: // "
+            {
+                size_t end = 0;
+                boolean_t plain = true;
+
+                const result_t r = string_end(end, plain);
+                if (result_t::s_ok != r)
+                    return fail(r), m_result;
+
+                m_pos = end;
+                break;
+            }
+            case 0x7B: // {
+            case 0x5B: // [
+                ++depth;
+                break;
+            case 0x7D: // }
+            case 0x5D: // ]
+                --depth;
+                break;
+            }
+
+            ++m_pos;
+        }
+
+        m_token = m_stack.back() ? token_t::object_end : token_t::array_end;
+        m_stack.pop_back();
+        after_value();
+
+        return result_t::s_ok;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::reader::string_end(size_t& end, boolean_t& plain)
+    {
+        end = m_pos + 1;
+        plain = true;
+
+        for (;;)
+        {
+            end += plain_run(m_data + end, m_len - end);
+
+            // the string goes on in the next chunk, the offset survives the refill
+            if (end + (end < m_len && 0x5C == m_data[end] ? 1 : 0) >= m_len)
+            {
+                const size_t offset = end - m_pos;
+                if (!fill())
+                    return result_t::s_need_more;
+
+                end = m_pos + offset;
+                continue;
+            }
+
+            if (0x22 == m_data[end])
+                return result_t::s_ok;
+
+            if (0x5C != m_data[end])  // unescaped control symbol
+                return result_t::e_unexpected;
+
+            plain = false;
+            end += 2;
+        }
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::reader::scan_string()
+    {
+        size_t end = 0;
+        boolean_t plain = true;
+
+        const result_t r = string_end(end, plain);
+        if (result_t::s_ok != r)
+            return r;
+
+        const size_t begin = m_pos + 1;
+        m_pos = end + 1;
+
+        if (plain)
+        {
+            m_view = string_view(m_data + begin, end - begin);
+            return result_t::s_ok;
+        }
+
+        const result_t d = decode_string(m_data + begin, m_data + end, m_string);
+        if (failed(d))
+            return d;
+
+        m_view = string_view(m_string.data(), m_string.size());
+        return result_t::s_ok;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::reader::scan_scalar()
+    {
+        size_t end = m_pos;
+        for (;;)
+        {
+            while (end < m_len && !is_space(m_data[end]) && 0x2C != m_data[end] && 0x5D != m_data[end] && 0x7D != m_data[end])
+                ++end;
+
+            if (end < m_len)
+                break;
+
+            // the scalar may go on in the next chunk
+            const size_t offset = end - m_pos;
+            const boolean_t more = fill();
+
+            end = m_pos + offset;
+            if (!more)
+                break;
+        }
+
+        const result_t r = decode_scalar(m_data + m_pos, m_data + end, m_scalar);
+        if (failed(r))
+            return r;
+
+        m_pos = end;
+        return result_t::s_ok;
+    }
     #pragma endregion
     //
-    #pragma region -- object parser declaration -- 
-        enum class e_object_states
+    #pragma region -- mapped file definition --
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::mapped_file::open(const std::string& path)
+    {
+        close();
+
+#if defined(_WIN32)
+        HANDLE file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (INVALID_HANDLE_VALUE == file)
+            return result_t::e_fatal;
+
+        LARGE_INTEGER size = {};
+        if (!::GetFileSizeEx(file, &size) || (uint64_t)size.QuadPart > (uint64_t)std::numeric_limits<size_t>::max())
         {
-            initial,        //
-            key_before,     //
-            key_inside,     //
-            key_after,      //
-            val_before,     //
-            val_inside,     //
-            val_after,      //
-            done,           //
-            failure,        //
-        };
+            ::CloseHandle(file);
+            return result_t::e_fatal;
+        }
 
-        enum class e_object_events
+        // an empty file can not be mapped
+        if (0 == size.QuadPart)
         {
-            // ascii part
-            obj_begin,      // {
-            obj_end,        // }
-            key_done,       //
-            key_error,      //
-            val_done,       //
-            val_error,      //
-            colon,          // :
-            comma,          // ,
-            symbol,         // any symbol
-            skip,           // space, tab, cr, lf
-            nothing,        // no action event
+            ::CloseHandle(file);
+            return result_t::s_ok;
+        }
+
+        // the view keeps the mapping and the file open
+        HANDLE mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (nullptr == mapping)
+            return result_t::e_fatal;
+
+        m_data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);
+        if (nullptr == m_data)
+            return result_t::e_fatal;
+
+        m_size = (size_t)size.QuadPart;
+#else
+        const int file = ::open(path.c_str(), O_RDONLY);
+        if (-1 == file)
+            return result_t::e_fatal;
+
+        struct stat st = {};
+        if (0 != ::fstat(file, &st) || (uint64_t)st.st_size > (uint64_t)std::numeric_limits<size_t>::max())
+        {
+            ::close(file);
+            return result_t::e_fatal;
+        }
+
+        // an empty file can not be mapped
+        if (0 == st.st_size)
+        {
+            ::close(file);
+            return result_t::s_ok;
+        }
+
+        // the mapping keeps the file open
+        void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        if (MAP_FAILED == data)
+            return result_t::e_fatal;
+
+        ::madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+
+        m_data = data;
+        m_size = (size_t)st.st_size;
+#endif
+
+        return result_t::s_ok;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void JSON_TEMPLATE_CLASS::mapped_file::close()
+    {
+        if (nullptr == m_data)
+            return;
+
+#if defined(_WIN32)
+        ::UnmapViewOfFile(m_data);
+#else
+        ::munmap(const_cast<void*>(m_data), m_size);
+#endif
+
+        m_data = nullptr;
+        m_size = 0;
+    }
+    #pragma endregion
+    //
+    #pragma region -- token decoders definition --
+    JSON_TEMPLATE_PARAMS
+    void
+    JSON_TEMPLATE_CLASS::append_code_point(string& out, const uint32_t cp)
+    {
+        if (1 < sizeof(symbol_t))
+        {
+            out.push_back((symbol_t)cp);
+        }
+        else if (cp < 0x80)
+        {
+            out.push_back((symbol_t)cp);
+        }
+        else if (cp < 0x800)
+        {
+            out.push_back((symbol_t)(0xC0 | (cp >> 6)));
+            out.push_back((symbol_t)(0x80 | (cp & 0x3F)));
+        }
+        else if (cp < 0x10000)
+        {
+            out.push_back((symbol_t)(0xE0 | (cp >> 12)));
+            out.push_back((symbol_t)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((symbol_t)(0x80 | (cp & 0x3F)));
+        }
+        else
+        {
+            out.push_back((symbol_t)(0xF0 | (cp >> 18)));
+            out.push_back((symbol_t)(0x80 | ((cp >> 12) & 0x3F)));
+            out.push_back((symbol_t)(0x80 | ((cp >> 6) & 0x3F)));
+            out.push_back((symbol_t)(0x80 | (cp & 0x3F)));
+        }
+    }
+
+    JSON_TEMPLATE_PARAMS
+    const typename JSON_TEMPLATE_CLASS::symbol_t*
+    JSON_TEMPLATE_CLASS::next_delimiter(const symbol_t* begin, const symbol_t* end, const symbol_t delim)
+    {
+        size_t depth = 0;
+
+        for (const symbol_t* p = begin; p < end; ++p)
+        {
+            switch (*p)
+            {
+            case 0x22: // "
+                for (++p; p < end; p += 0x5C == *p ? 2 : 1)
+                {
+                    p += plain_run(p, end - p);
+                    if (p >= end || 0x22 == *p)
+                        break;
+                }
+                if (p >= end)
+                    return end;
+                break;
+            case 0x7B: // {
+            case 0x5B: // [
+                ++depth;
+                break;
+            case 0x7D: // }
+            case 0x5D: // ]
+                if (0 == depth)
+                    return p;
+                --depth;
+                break;
+            default:
+                if (delim == *p && 0 == depth)
+                    return p;
+                break;
+            }
+        }
+
+        return end;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::decode_string(const symbol_t* begin, const symbol_t* end, string& out)
+    {
+        auto hex4 = [](const symbol_t* p, uint32_t& cu)->boolean_t
+        {
+            cu = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                const int h = detail::hex_value((uint32_t)p[i]);
+                if (h < 0)
+                    return false;
+                cu = (cu << 4) | (uint32_t)h;
+            }
+            return true;
         };
 
-        class object_parser_t
-            : public parser_impl<obj, e_object_events, e_object_states, e_object_states::initial>
+        out.clear();
+        out.reserve(end - begin);
+
+        const symbol_t* p = begin;
+        while (p < end)
         {
-            using event_t = e_object_events;
-            using state_t = e_object_states;
-            using EventToStateTable_t = StateTable<state_t, event_t>;
+            // copy the run of plain symbols at once
+            const size_t run = plain_run(p, end - p);
+            out.append(p, run);
+            p += run;
 
-        public:
-            // {ctor}
-            object_parser_t()
-                : m_event_2_state_table
-            {
-                { state_t::initial,    { { event_t::obj_begin, { state_t::key_before, STD_BIND_TO_THIS( object_parser_t, on_begin   ) } },
-                                         { event_t::skip,      { state_t::val_before, STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                                         { event_t::symbol,    { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                } },
-                { state_t::key_before, { { event_t::obj_end,   { state_t::done,       STD_BIND_TO_THIS( object_parser_t, on_done    ) } },
-                                         { event_t::key_error, { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                                         { event_t::symbol,    { state_t::key_inside, STD_BIND_TO_THIS( object_parser_t, on_key     ) } },
-                                         { event_t::skip,      { state_t::key_before, STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                } },
-                { state_t::key_inside, { { event_t::key_done,  { state_t::key_after,  STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                                         { event_t::key_error, { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                                         { event_t::symbol,    { state_t::key_inside, STD_BIND_TO_THIS( object_parser_t, on_key     ) } },
-                } },
-                { state_t::key_after,  { { event_t::colon,     { state_t::val_before, STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                                         { event_t::skip,      { state_t::key_after,  STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                } },
-                { state_t::val_before, { { event_t::symbol,    { state_t::val_inside, STD_BIND_TO_THIS( object_parser_t, on_val     ) } },
-                                         { event_t::val_error, { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                                         { event_t::skip,      { state_t::val_before, STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                } },
-                { state_t::val_inside, { { event_t::val_done,  { state_t::val_after,  STD_BIND_TO_THIS( object_parser_t, on_got_val ) } },
-                                         { event_t::val_error, { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                                         { event_t::symbol,    { state_t::val_inside, STD_BIND_TO_THIS( object_parser_t, on_val     ) } },
-                } },
-                { state_t::val_after,  { { event_t::comma,     { state_t::key_before, STD_BIND_TO_THIS( object_parser_t, on_new     ) } },
-                                         { event_t::obj_end,   { state_t::done,       STD_BIND_TO_THIS( object_parser_t, on_done    ) } },
-                                         { event_t::skip,      { state_t::val_after,  STD_BIND_TO_THIS( object_parser_t, on_more    ) } },
-                } },
-                { state_t::done,       { { event_t::symbol,    { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                } },
-                { state_t::failure,    { { event_t::symbol,    { state_t::failure,    STD_BIND_TO_THIS( object_parser_t, on_fail    ) } },
-                } },
-            } {};
+            if (p == end)
+                break;
 
-        protected:
-            // inherited via parser
-            virtual void reset() final;
+            if (0x5C != *p)         // unescaped control symbol
+                return result_t::e_unexpected;
 
-            virtual result_t putchar(const symbol_t& c, const int pos) final;
+            if (++p == end)
+                return result_t::e_unexpected;
 
-            virtual value get() const final;
+            const symbol_t c = *p++;
+            const uint8_t symbol = detail::unescape((uint32_t)c);
+
+            if (0 != symbol)
+            {
+                out.push_back((symbol_t)symbol);
+                continue;
+            }
+
+            if (0x75 != c)          // neither single symbol escape nor \uXXXX
+                return result_t::e_unexpected;
+
+            uint32_t cp = 0;
+            if (end - p < 4 || !hex4(p, cp))
+                return result_t::e_unexpected;
+            p += 4;
+
+            // surrogate pair
+            uint32_t low = 0;
+            if (1 == sizeof(symbol_t) && 0xD800 <= cp && cp <= 0xDBFF && end - p >= 6 && 0x5C == p[0] && 0x75 == p[1] && hex4(p + 2, low) && 0xDC00 <= low && low <= 0xDFFF)
+            {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+
+            append_code_point(out, cp);
+        }
+
+        return result_t::s_ok;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::decode_number(const symbol_t* begin, const symbol_t* end, value& out)
+    {
+        auto is_digit = [](const symbol_t& c)->boolean_t { return 0x30 <= c && c <= 0x39; };
+
+        number num;
+        const symbol_t* p = begin;
+
+        if (p < end && 0x2D == *p)
+            num.m_positive = false, ++p;
+
+        if (p == end || !is_digit(*p))
+            return result_t::e_unexpected;
+
+        if (0x30 == *p)
+            ++p;
+        else
+            while (p < end && is_digit(*p))
+                num.integer_digit((uint32_t)(*p++ - 0x30));
+
+        if (p < end && 0x2E == *p)
+        {
+            if (++p == end || !is_digit(*p))
+                return result_t::e_unexpected;
+
+            while (p < end && is_digit(*p))
+                num.fractional_digit((uint32_t)(*p++ - 0x30));
+        }
+
+        if (p < end && (0x45 == *p || 0x65 == *p))
+        {
+            num.m_is_float = true;
+
+            if (++p < end && (0x2B == *p || 0x2D == *p))
+                num.m_exponent_positive = (0x2B == *p++);
+
+            if (p == end || !is_digit(*p))
+                return result_t::e_unexpected;
+
+            while (p < end && is_digit(*p))
+                num.exponent_digit((uint32_t)(*p++ - 0x30));
+        }
+
+        if (p != end)
+            return result_t::e_unexpected;
+
+        out = num.to_value();
+        return result_t::s_ok;
+    }
+
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::decode_scalar(const symbol_t* begin, const symbol_t* end, value& out)
+    {
+        auto is = [begin, end](const char* literal)->boolean_t
+        {
+            const symbol_t* p = begin;
+            for (; p < end && *literal; ++p, ++literal)
+                if (*p != (symbol_t)*literal)
+                    return false;
+            return p == end && 0 == *literal;
+        };
+
+        switch (*begin)
+        {
+        case 0x74: // t
+            if (!is("true"))
+                return result_t::e_unexpected;
+            out = (boolean_t)true;
+            return result_t::s_ok;
+        case 0x66: // f
+            if (!is("false"))
+                return result_t::e_unexpected;
+            out = (boolean_t)false;
+            return result_t::s_ok;
+        case 0x6E: // n
+            if (!is("null"))
+                return result_t::e_unexpected;
+            out = nullptr;
+            return result_t::s_ok;
+        }
 
-            // inherited via parser_impl
-            virtual const EventToStateTable_t& table() override;
+        return decode_number(begin, end, out);
+    }
+    #pragma endregion
+    //
+    #pragma region -- structural parser definition --
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::structural_parser_t::parse(const symbol_t* data, const size_t len, value& jsval)
+    {
+        const result_t result = index(data, len);
+        if (result_t::s_ok != result)
+            return result;
 
-            virtual event_t to_event(const symbol_t& c)   const override;
+        return build(data, len, jsval);
+    }
 
-            virtual event_t to_event(const result_t& r) const override;
+    JSON_TEMPLATE_PARAMS
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::structural_parser_t::index(const symbol_t* data, const size_t len)
+    {
+        m_indices.clear();
+        m_indices.reserve(len / 8 + 16);
 
-            // own methods
-            result_t on_more(const symbol_t& c, const int pos);
+        uint64_t prev_escaped   = 0;    // the previous block ended by an odd backslash sequence
+        uint64_t prev_in_string = 0;    // all ones if the previous block ended inside of a string
+        uint64_t prev_scalar    = 0;    // the previous block ended by a scalar symbol
 
-            result_t on_begin(const symbol_t& c, const int pos);
+        uint8_t tail[64];
 
-            result_t on_new(const symbol_t& c, const int pos);
+        for (size_t offset = 0; offset < len; offset += 64)
+        {
+            const uint8_t* block = reinterpret_cast<const uint8_t*>(data + offset);
 
-            result_t on_key(const symbol_t& c, const int pos);
+            if (len - offset < 64)
+            {
+                // pad the last block with spaces
+                memset(tail, 0x20, sizeof(tail));
+                memcpy(tail, block, len - offset);
+                block = tail;
+            }
 
-            result_t on_val(const symbol_t& c, const int pos);
+            detail::block_masks m;
+            detail::classify(block, m);
 
-            result_t on_done(const symbol_t& c, const int pos);
+            const uint64_t escaped   = detail::escaped(m.backslash, prev_escaped);
+            const uint64_t quote     = m.quote & ~escaped;
+            const uint64_t in_string = detail::prefix_xor(quote) ^ prev_in_string;
+            prev_in_string = (uint64_t)((int64_t)in_string >> 63);
 
-            result_t on_fail(const symbol_t& c, const int pos);
+            const uint64_t scalar    = ~(m.op | m.space | quote | in_string);
+            const uint64_t follows   = (scalar << 1) | prev_scalar;
+            prev_scalar = scalar >> 63;
 
-            result_t on_got_val(const symbol_t& c, const int pos);
-        protected:
-            const EventToStateTable_t m_event_2_state_table;
+            uint64_t structural = (m.op & ~in_string) | quote | (scalar & ~follows);
 
-            typename parser::ptr m_key_parser;
-            typename parser::ptr m_val_parser;
-        };
-    #pragma endregion 
-    //////////////////////////////////////////////////////////////////////////
-    #pragma region -- factory --
-        /// creates object parser
-        inline static typename parser::ptr create() 
-        { 
-            return parser::ptr(new object_parser_t()); 
+            while (0 != structural)
+            {
+                m_indices.push_back(offset + detail::trailing_zeros(structural));
+                structural &= structural - 1;
+            }
         }
-    #pragma endregion
-    //////////////////////////////////////////////////////////////////////////
-    };
-    //////////////////////////////////////////////////////////////////////////
-    using json = json_t<>;
-    //////////////////////////////////////////////////////////////////////////
-    #pragma region -- json data definition --
-    JSON_TEMPLATE_PARAMS
-    JSON_TEMPLATE_CLASS::obj::obj(std::initializer_list<JSON_TEMPLATE_CLASS::pair_t<typename JSON_TEMPLATE_CLASS::string, typename JSON_TEMPLATE_CLASS::value>> l)
-    {
-        for (auto arg : l)
-            insert(arg);
+
+        // unterminated string
+        return 0 != prev_in_string ? result_t::s_need_more : result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::string
-    JSON_TEMPLATE_CLASS::obj::str(typename JSON_TEMPLATE_CLASS::sstream& str) const
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::structural_parser_t::build(const symbol_t* data, const size_t len, value& jsval)
     {
-        // leading curly brace
-        str << "{";
+        enum class expect
+        {
+            value,              // any value
+            first_value_or_end, // a value or ]
+            first_key_or_end,   // a key or }
+            key,                // a key
+            colon,              // :
+            comma_or_end,       // , or the end of the current container
+            nothing,            // the root value is complete
+        };
 
-        for (auto it = begin(); it != end(); ++it)
+        auto is_op = [](const symbol_t& c)->boolean_t
         {
-            const boolean_t last = (--end() == it);
+            return 0x7B == c || 0x7D == c || 0x5B == c || 0x5D == c || 0x3A == c || 0x2C == c;
+        };
 
-            // key
-            str << "\"" << it->first << "\":";
+        vector_t<frame> stack;
+        expect e = expect::value;
+        const size_t count = m_indices.size();
+        size_t k = 0;
 
-            // value
-            switch ((value::vt)it->second.index())
+        // puts the complete value to the enclosing container or to the root
+        auto emit = [&stack, &jsval, &e](value&& v)
+        {
+            if (stack.empty())
             {
-            case value::vt::t_string:
-                str << "\"" << container::serialize_string(it->second.get<string>()) << "\"";
-                break;
-            case value::vt::t_object:
-                it->second.get<obj>().str(str);
-                break;
-            case value::vt::t_array:
-                it->second.get<arr>().str(str);
-                break;
-            case value::vt::t_integer:
-                str << it->second.get<integer_t>();
-                break;
-            case value::vt::t_floatingpt:
-                str << std::scientific << it->second.get<floatingpt_t>();
-                break;
-            case value::vt::t_boolean:
-                str << (it->second.get<boolean_t>() ? "true" : "false");
-                break;
-            case value::vt::t_null:
-                str << "null";
-                break;
-            default: // unknown(i.e. not mentioned) type
-                assert(0);
-                break;
+                jsval = std::move(v);
+                e = expect::nothing;
+                return;
             }
 
-            // comma if not the last one
-            str << (last ? "" : ",");
-        }
-
-        // trailing curly brace
-        str << "}";
-
-        return str.str();
-    }
+            frame& top = stack.back();
+            if (top.is_object)
+                top.o[std::move(top.key)] = std::move(v);
+            else
+                top.a.push_back(std::move(v));
 
-    JSON_TEMPLATE_PARAMS
-    JSON_TEMPLATE_CLASS::arr::arr(std::initializer_list<value> l)
-    {
-        for (auto arg : l)
-            push_back(arg);
-    }
+            e = expect::comma_or_end;
+        };
 
-    JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::string
-    JSON_TEMPLATE_CLASS::arr::str(typename JSON_TEMPLATE_CLASS::sstream& str) const
-    {
-        // leading curly brace
-        str << "[";
+        auto close = [&stack, &emit]()
+        {
+            frame& top = stack.back();
+            value v = top.is_object ? value(std::move(top.o)) : value(std::move(top.a));
+            stack.pop_back();
+            emit(std::move(v));
+        };
 
-        for (auto it = begin(); it != end(); ++it)
+        while (k < count)
         {
-            const boolean_t last = (--end() == it);
+            const size_t pos = m_indices[k++];
+            const symbol_t c = data[pos];
 
-            // value
-            switch ((value::vt)it->index())
+            switch (e)
             {
-            case value::vt::t_string:
-                str << "\"" << container::serialize_string((*it).get<string>())<< "\"";
-                break;
-            case value::vt::t_object:
-                (*it).get<obj>().str(str);
-                break;
-            case value::vt::t_array:
-                (*it).get<arr>().str(str);
-                break;
-            case value::vt::t_integer:
-                str << (*it).get<integer_t>();
-                break;
-            case value::vt::t_floatingpt:
-                str << std::scientific << (*it).get<floatingpt_t>();
+            case expect::first_value_or_end:
+                if (0x5D == c) // ]
+                {
+                    close();
+                    break;
+                }
+                // no break
+            case expect::value:
+                switch (c)
+                {
+                case 0x7B: // {
+                    stack.emplace_back();
+                    stack.back().is_object = true;
+                    e = expect::first_key_or_end;
+                    break;
+                case 0x5B: // [
+                    stack.emplace_back();
+                    e = expect::first_value_or_end;
+                    break;
+                case 0x22: // "
+                {
+                    if (k == count)
+                        return result_t::s_need_more;
+
+                    string str;
+                    const result_t r = decode_string(data + pos + 1, data + m_indices[k++], str);
+                    if (failed(r))
+                        return r;
+
+                    emit(value(std::move(str)));
+                    break;
+                }
+                default:
+                {
+                    if (is_op(c))
+                        return result_t::e_unexpected;
+
+                    size_t last = pos;
+                    while (last < len && !is_space(data[last]) && !is_op(data[last]) && 0x22 != data[last])
+                        ++last;
+
+                    value v;
+                    const result_t r = decode_scalar(data + pos, data + last, v);
+                    if (failed(r))
+                        return r;
+
+                    emit(std::move(v));
+                    break;
+                }
+                }
                 break;
-            case value::vt::t_boolean:
-                str << (((*it).get<boolean_t>() ? "true" : "false"));
+            case expect::first_key_or_end:
+                if (0x7D == c) // }
+                {
+                    close();
+                    break;
+                }
+                // no break
+            case expect::key:
+            {
+                if (0x22 != c || k == count)
+                    return 0x22 != c ? result_t::e_unexpected : result_t::s_need_more;
+
+                const result_t r = decode_string(data + pos + 1, data + m_indices[k++], stack.back().key);
+                if (failed(r))
+                    return r;
+
+                e = expect::colon;
                 break;
-            case value::vt::t_null:
-                str << "null";
+            }
+            case expect::colon:
+                if (0x3A != c)
+                    return result_t::e_unexpected;
+
+                e = expect::value;
                 break;
-            default:
-                assert(0);
+            case expect::comma_or_end:
+                if (0x2C == c) // ,
+                    e = stack.back().is_object ? expect::key : expect::value;
+                else if ((stack.back().is_object ? 0x7D : 0x5D) == c)
+                    close();
+                else
+                    return result_t::e_unexpected;
                 break;
+            case expect::nothing:
+                // trailing symbols after the root value
+                return result_t::e_unexpected;
             }
-
-            // comma if not the last one
-            str << (last ? "" : ",");
         }
 
-        // trailing curly brace
-        str << "]";
-
-        return str.str();
+        return expect::nothing == e ? result_t::s_done : result_t::s_need_more;
     }
     #pragma endregion
     //
-    #pragma region -- string parser definition --
-    JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::string_parser_t::reset()
-    {
-        state::set(state_t::initial);
-        m_value.reset();
-    };
-
+    #pragma region -- flat parser definition --
     JSON_TEMPLATE_PARAMS
+    template <class HandlerT>
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::putchar(const symbol_t& c, const int pos)
-    {
-        return parser_impl::step(to_event(c), c, pos);
-    };
-
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::string_parser_t::get() const
+    JSON_TEMPLATE_CLASS::flat_parser_t<HandlerT>::parse(const symbol_t* data, const size_t len)
     {
-        if (m_value)
-            return *m_value;
+        enum class expect
+        {
+            value,              // any value
+            first_value_or_end, // a value or ]
+            first_key_or_end,   // a key or }
+            key,                // a key
+            colon,              // :
+            comma_or_end,       // , or the end of the current container
+            nothing,            // the root value is complete
+        };
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
+        m_stack.clear();
 
-    JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::string_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::string_parser_t::table()
-    {
-        return m_event_2_state_table;
-    }
+        expect e = expect::value;
+        size_t i = 0;
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::string_parser_t::event_t
-    JSON_TEMPLATE_CLASS::string_parser_t::to_event(const symbol_t& c) const
-    {
-        event_t smb = event_t::symbol;
-        switch (state::get())
+        while (i < len)
         {
-        case state_t::initial:
-            if (0x22 == c)
-                smb = event_t::quote;
-            break;
-        case state_t::inside:
-            if (0x5C == c)
-                smb = event_t::back_slash;
-            if (0x22 == c)
-                smb = event_t::quote;
-            break;
-        case state_t::escape:
-            switch (c)
+            const symbol_t c = data[i];
+
+            if (is_space(c))
             {
-            case 0x22:  smb = event_t::quote;       break;
-            case 0x5C:  smb = event_t::back_slash;  break;
-            case 0x2F:  smb = event_t::slash;       break;
-            case 0x62:  smb = event_t::alpha_b;     break;
-            case 0x66:  smb = event_t::alpha_f;     break;
-            case 0x6E:  smb = event_t::alpha_n;     break;
-            case 0x72:  smb = event_t::alpha_r;     break;
-            case 0x74:  smb = event_t::alpha_t;     break;
-            case 0x75:  smb = event_t::alpha_u;     break;
+                ++i;
+                continue;
             }
-            break;
-        case state_t::unicode_1:
-        case state_t::unicode_2:
-        case state_t::unicode_3:
-        case state_t::unicode_4:
-            if (0x30 <= c && c <= 0x39)
-                smb = event_t::hex_digit;
-            if (0x41 <= c && c <= 0x46)
-                smb = event_t::hex_digit;
-            if (0x61 <= c && c <= 0x66)
-                smb = event_t::hex_digit;
-            break;
-        case state_t::done:
-            assert(0);
-            break;
+
+            result_t r = result_t::s_ok;
+
+            switch (e)
+            {
+            case expect::first_value_or_end:
+                if (0x5D == c) // ]
+                {
+                    m_stack.pop_back(), ++i;
+                    r = m_handler.on_array_end();
+                    e = m_stack.empty() ? expect::nothing : expect::comma_or_end;
+                    break;
+                }
+                // no break
+            case expect::value:
+                switch (c)
+                {
+                case 0x7B: // {
+                case 0x5B: // [
+                    if (0 != m_max_depth && m_stack.size() >= m_max_depth)
+                        return result_t::e_depth_limit;
+
+                    m_stack.push_back(0x7B == c), ++i;
+                    r = 0x7B == c ? m_handler.on_object_begin() : m_handler.on_array_begin();
+                    e = 0x7B == c ? expect::first_key_or_end : expect::first_value_or_end;
+                    break;
+                case 0x22: // "
+                    r = scan_string(data, len, i);
+                    if (result_t::s_ok == r)
+                        r = report_string(false, detail::borrows_strings<HandlerT>());
+                    e = m_stack.empty() ? expect::nothing : expect::comma_or_end;
+                    break;
+                default:
+                    r = scan_scalar(data, len, i);
+                    e = m_stack.empty() ? expect::nothing : expect::comma_or_end;
+                    break;
+                }
+                break;
+            case expect::first_key_or_end:
+                if (0x7D == c) // }
+                {
+                    m_stack.pop_back(), ++i;
+                    r = m_handler.on_object_end();
+                    e = m_stack.empty() ? expect::nothing : expect::comma_or_end;
+                    break;
+                }
+                // no break
+            case expect::key:
+                if (0x22 != c)
+                    return result_t::e_unexpected;
+
+                r = scan_string(data, len, i);
+                if (result_t::s_ok == r)
+                    r = report_string(true, detail::borrows_strings<HandlerT>());
+                e = expect::colon;
+                break;
+            case expect::colon:
+                if (0x3A != c)
+                    return result_t::e_unexpected;
+
+                ++i;
+                e = expect::value;
+                break;
+            case expect::comma_or_end:
+                if (0x2C == c) // ,
+                {
+                    ++i;
+                    e = m_stack.back() ? expect::key : expect::value;
+                }
+                else if ((m_stack.back() ? 0x7D : 0x5D) == c)
+                {
+                    const boolean_t is_object = m_stack.back();
+                    m_stack.pop_back(), ++i;
+                    r = is_object ? m_handler.on_object_end() : m_handler.on_array_end();
+                    e = m_stack.empty() ? expect::nothing : expect::comma_or_end;
+                }
+                else
+                {
+                    return result_t::e_unexpected;
+                }
+                break;
+            case expect::nothing:
+                // trailing symbols after the root value
+                return result_t::e_unexpected;
+            }
+
+            if (result_t::s_ok != r)
+                return r;
         }
 
-        return smb;
-    };
+        return expect::nothing == e ? result_t::s_done : result_t::s_need_more;
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::string_parser_t::event_t
-    JSON_TEMPLATE_CLASS::string_parser_t::to_event(const result_t& c) const
+    template <class HandlerT>
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::flat_parser_t<HandlerT>::scan_string(const symbol_t* data, const size_t len, size_t& i)
     {
-        return event_t::symbol;
-    };
+        const size_t begin = i + 1;
+        boolean_t plain = true;
+
+        size_t end = begin;
+        for (;;)
+        {
+            end += plain_run(data + end, len - end);
+            if (end >= len)
+                return result_t::s_need_more;
+
+            if (0x22 == data[end])
+                break;
+
+            if (0x5C != data[end])  // unescaped control symbol
+                return result_t::e_unexpected;
+
+            plain = false;
+            end += 2;
+            if (end >= len)
+                return result_t::s_need_more;
+        }
+
+        i = end + 1;
+
+        m_plain = plain;
+        if (plain)
+        {
+            m_view = string_view(data + begin, end - begin);
+            return result_t::s_ok;
+        }
+
+        return decode_string(data + begin, data + end, m_string);
+    }
 
     JSON_TEMPLATE_PARAMS
+    template <class HandlerT>
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_initial(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::flat_parser_t<HandlerT>::report_string(const boolean_t is_key, std::true_type)
     {
-        return result_t::s_need_more;
+        if (m_plain)
+            return is_key ? m_handler.on_key_view(m_view) : m_handler.on_string_view(m_view);
+
+        return is_key ? m_handler.on_key(m_string) : m_handler.on_string(m_string);
     }
 
     JSON_TEMPLATE_PARAMS
+    template <class HandlerT>
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_inside(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::flat_parser_t<HandlerT>::report_string(const boolean_t is_key, std::false_type)
     {
-        if (!m_value)
-            m_value.emplace();
-
-        (*m_value) += c;
+        if (m_plain)
+            m_string.assign(m_view.data(), m_view.data() + m_view.size());
 
-        return result_t::s_need_more;
+        return is_key ? m_handler.on_key(m_string) : m_handler.on_string(m_string);
     }
 
     JSON_TEMPLATE_PARAMS
+    template <class HandlerT>
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_escape(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::flat_parser_t<HandlerT>::scan_scalar(const symbol_t* data, const size_t len, size_t& i)
     {
-        result_t result = result_t::s_need_more;
-        const state_t s = state::get();
+        size_t end = i;
+        while (end < len && !is_space(data[end]) && 0x2C != data[end] && 0x5D != data[end] && 0x7D != data[end])
+            ++end;
+
+        const result_t r = decode_scalar(data + i, data + end, m_scalar);
+        if (failed(r))
+            return r;
+
+        i = end;
 
-        if (state_t::inside == s)
+        switch ((typename value::vt)m_scalar.index())
         {
-            m_cache.clear();
-            m_cache.push_back(c);
+        case value::vt::t_integer:
+            return m_handler.on_integer(m_scalar.get<integer_t>());
+        case value::vt::t_floatingpt:
+            return m_handler.on_floatingpt(m_scalar.get<floatingpt_t>());
+        case value::vt::t_boolean:
+            return m_handler.on_boolean(m_scalar.get<boolean_t>());
+        case value::vt::t_null:
+            return m_handler.on_null();
         }
-        else if (state_t::escape == state::get() && m_cache.size() == 1 && m_cache[0] == '\\')
-        {
-            assert(m_value);
-    
-            m_cache.push_back(c);
-#pragma warning( push )
-#pragma warning( disable : 4129 )
-            if (m_cache == "\\b")        // got backspace sequence
-                (*m_value) += '\b', m_cache.clear();
-            else if (m_cache == "\\f")   // got formfeed sequence
-                (*m_value) += '\f', m_cache.clear();
-            else if (m_cache == "\\n")   // got newline sequence
-                (*m_value) += '\n', m_cache.clear();
-            else if (m_cache == "\\r")   // got carriage return sequence
-                (*m_value) += '\r', m_cache.clear();
-            else if (m_cache == "\\t")   // got hotisontal tab sequence
-                (*m_value) += '\t', m_cache.clear();
-            else if (m_cache == "\\\"")  // got double quote as symbol sequence
-                (*m_value) += m_cache, m_cache.clear();
-            else if (m_cache == "\\\\")  // got backslash as symbol sequence
-                (*m_value) += m_cache, m_cache.clear();
-            else if (m_cache == "\\/")   // got slash as symbol sequence
-                (*m_value) += "\/", m_cache.clear();
-            else if (m_cache != "\\u")   // got any other symbol except \u
-                result = result_t::e_unexpected;
-        }
-#pragma warning( pop )
-        return result;
+
+        return result_t::e_unexpected;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_unicode(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::dom_builder_t::open(const boolean_t is_object)
     {
-        result_t result = result_t::s_need_more;
+        if (m_stack.size() == m_depth)
+            m_stack.emplace_back();
 
-        assert(m_value);
+        frame& top = m_stack[m_depth++];
+        top.is_object = is_object;
+        top.o.clear();
+        top.a.clear();
 
-        switch (state::get())
-        {
-        case state_t::unicode_1:
-        case state_t::unicode_2:
-        case state_t::unicode_3:
-            m_cache.push_back(c);
-            break;
-        case state_t::unicode_4:
-            m_cache.push_back(c);
-            assert(0); // once you got here - implement correct inserting of the 4byte symbol into the string
-            (*m_value) += m_cache;
-            m_cache.clear();
-            break;
-        default:
-            result = result_t::e_unexpected;
-        }
-        (*m_value) += c;
-        return result;
+        return result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_done(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::dom_builder_t::close()
     {
-        if (!m_value)
-            m_value.emplace();
+        frame& top = m_stack[--m_depth];
 
-        return result_t::s_done;
+        value v = top.is_object ? value(std::move(top.o)) : value(std::move(top.a));
+        top.o.clear();
+        top.a.clear();
+
+        return emit(std::move(v));
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::string_parser_t::on_fail(const symbol_t&c, const int pos)
+    JSON_TEMPLATE_CLASS::dom_builder_t::emit(value&& v)
     {
-        return result_t::e_unexpected;
+        if (0 == m_depth)
+        {
+            m_root = std::move(v);
+            return result_t::s_ok;
+        }
+
+        frame& top = m_stack[m_depth - 1];
+        if (top.is_object)
+            top.o[std::move(top.key)] = std::move(v);
+        else
+            top.a.push_back(std::move(v));
+
+        return result_t::s_ok;
     }
     #pragma endregion
     //
-    #pragma region -- number parser definition --
+    #pragma region -- borrowed document definition --
     JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::number_parser_t::reset()
+    const typename JSON_TEMPLATE_CLASS::document::node*
+    JSON_TEMPLATE_CLASS::document::members::find(const string_view& key) const
     {
-        state::set(state_t::initial);
+        for (const auto& member : *this)
+        {
+            if (member.first == key)
+                return &member.second;
+        }
 
-        m_value.reset();
+        return nullptr;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::putchar(const symbol_t& c, const int pos)
+    const typename JSON_TEMPLATE_CLASS::document::node&
+    JSON_TEMPLATE_CLASS::document::node::operator[](const string_view& key) const
     {
-        return parser_impl::step(to_event(c), c, pos);
+        if (!is_object())
+            throw std::logic_error("Not an object.");
+
+        const node* n = get<members>().find(key);
+        if (nullptr == n)
+            throw std::out_of_range("No such member.");
+
+        return *n;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::number_parser_t::get() const
+    const typename JSON_TEMPLATE_CLASS::document::node&
+    JSON_TEMPLATE_CLASS::document::node::operator[](const size_t idx) const
     {
-        if (m_value)
-        {
-            value val;
-            const number& num = (*m_value);
-            // contruct decimal fraction
-            if (num.m_fractional_value > 0)
-            {
-                // 1. put fractional part and shift all it's digits to the right
-                // 2. add integer part
-                double result = ((double)num.m_fractional_value) / pow(10, num.m_fractional_digits) + num.m_integer;
-                // 3. apply power
-                const uint32_t power = (uint32_t)pow(10, num.m_exponent_value);
-                if (num.m_has_exponent)
-                    result = num.m_exponent_positive ? result * power : result / power;
-                // 4. apply sign
-                val = (num.m_positive ? 1.0 : -1.0) * result;
-            }
-            else
-            {
-                int64_t i64 = num.m_integer;
-                if (!num.m_positive)
-                    i64 *= -1;
-                val = i64;
-            }
-
-            return val;
-        }
+        if (!is_array())
+            throw std::logic_error("Not an array.");
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
+        return get<elements>().at(idx);
+    }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::number_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::number_parser_t::table()
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::document::node::to_value() const
     {
-        return m_event_2_state_table;
+        switch (index())
+        {
+        case value::vt::t_string:
+        {
+            const string_view& str = get<string_view>();
+            return value(string(str.data(), str.size()));
+        }
+        case value::vt::t_object:
+        {
+            obj o;
+            for (const auto& member : get<members>())
+                o[string(member.first.data(), member.first.size())] = member.second.to_value();
+            return value(std::move(o));
+        }
+        case value::vt::t_array:
+        {
+            arr a;
+            a.reserve(get<elements>().size());
+            for (const node& element : get<elements>())
+                a.push_back(element.to_value());
+            return value(std::move(a));
+        }
+        case value::vt::t_integer:
+            return value(get<integer_t>());
+        case value::vt::t_floatingpt:
+            return value(get<floatingpt_t>());
+        case value::vt::t_boolean:
+            return value(get<boolean_t>());
+        case value::vt::t_null:
+            break;
+        }
+
+        return value(null_t());
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::number_parser_t::event_t
-    JSON_TEMPLATE_CLASS::number_parser_t::to_event(const symbol_t& c) const
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::document::parse(const symbol_t* data, const size_t len, const size_t max_depth)
     {
-        if (0x2D == c)
-            return event_t::minus;
-        if (0x2B == c)
-            return event_t::plus;
-        if (0x30 == c)
-            return event_t::dec_zero;
-        if (0x2E == c)
-            return event_t::dot;
-        if (0x45 == c || 0x65 == c)
-            return event_t::exponent;
-        if (0x31 <= c && c <= 0x39)
-            return event_t::dec_digit;
+        m_root = node();
+        m_strings.clear();
 
-        return event_t::symbol;
-    };
+        builder_t builder(*this);
+        flat_parser_t<builder_t> parser(builder, max_depth);
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::number_parser_t::event_t
-    JSON_TEMPLATE_CLASS::number_parser_t::to_event(const result_t& c) const
-    {
-        return event_t::symbol;
-    };
+        const result_t result = parser.parse(data, len);
+        if (result_t::s_done != result)
+        {
+            m_root = node();
+            m_strings.clear();
+        }
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_initial(const symbol_t& c, const int pos)
-    {
-        // TODO: use symbol
-        return result_t::s_need_more;
+        return result;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_minus(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::document::parse_file(const std::string& path, const size_t max_depth)
     {
-        if (!m_value)
-            m_value.emplace();
+        m_root = node();
+        m_strings.clear();
 
-        (*m_value).m_positive = false;
+        std::unique_ptr<mapped_file> file(new mapped_file());
 
-        return result_t::s_need_more;
+        const result_t result = file->open(path);
+        if (failed(result))
+            return result;
+
+        m_file = std::move(file);
+        return parse(m_file->data(), m_file->size(), max_depth);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_integer(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::string_view
+    JSON_TEMPLATE_CLASS::document::builder_t::keep(string& str)
     {
-        if (!m_value)
-            m_value.emplace();
-
-        const result_t res = append_digit((*m_value).m_integer, c);
-        return result_t::s_ok == res ? result_t::s_need_more : res;
+        m_doc.m_strings.push_back(std::move(str));
+        return string_view(m_doc.m_strings.back().data(), m_doc.m_strings.back().size());
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_fractional(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::document::builder_t::open(const boolean_t is_object)
     {
-        assert(m_value);
-        const result_t res = append_digit((*m_value).m_fractional_value, c);
-        (*m_value).m_fractional_digits++;
-        return result_t::s_ok == res ? result_t::s_need_more : res;
+        if (m_stack.size() == m_depth)
+            m_stack.emplace_back();
+
+        frame& top = m_stack[m_depth++];
+        top.is_object = is_object;
+        top.o.clear();
+        top.a.clear();
+
+        return result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_exponent(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::document::builder_t::close()
     {
-        assert(m_value);
-        (*m_value).m_has_exponent = true;
-        return result_t::s_need_more;
+        frame& top = m_stack[--m_depth];
+
+        node n = top.is_object ? node(std::move(top.o)) : node(std::move(top.a));
+        top.o.clear();
+        top.a.clear();
+
+        return emit(std::move(n));
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_exp_sign(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::document::builder_t::emit(node&& n)
     {
-        assert(m_value);
-
-        switch (c)
+        if (0 == m_depth)
         {
-        case 0x2D:
-            (*m_value).m_exponent_positive = false; break;
-        case 0x2B:
-            (*m_value).m_exponent_positive = true; break;
-        default:
-            return result_t::e_fatal;
+            m_doc.m_root = std::move(n);
+            return result_t::s_ok;
         }
-        return result_t::s_need_more;
-    }
 
+        frame& top = m_stack[m_depth - 1];
+        if (top.is_object)
+            top.o.emplace_back(top.key, std::move(n));
+        else
+            top.a.push_back(std::move(n));
+
+        return result_t::s_ok;
+    }
+    #pragma endregion
+    //
+    #pragma region -- lazy document definition --
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_exp_value(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::lazy_document::parse(const symbol_t* data, const size_t len)
     {
-        assert(m_value);
-        const result_t res = append_digit((*m_value).m_exponent_value, c);
-        return result_t::s_ok == res ? result_t::s_need_more : res;
+        m_nodes->clear();
+
+        const symbol_t* begin = data;
+        const symbol_t* end = data + len;
+        while (begin < end && is_space(*begin))
+            ++begin;
+        while (begin < end && is_space(*(end - 1)))
+            --end;
+
+        if (begin == end)
+            return result_t::s_need_more;
+
+        // the container must end by its closing bracket, the rest is checked on access
+        const symbol_t first = *begin;
+        const symbol_t last = *(end - 1);
+        if ((0x7B == first && (0x7D != last || end - begin < 2)) || (0x5B == first && (0x5D != last || end - begin < 2)))
+            return result_t::s_need_more;
+
+        lazy_node root;
+        root.begin = begin;
+        root.end = end;
+        root.scan = begin + 1;
+        m_nodes->push_back(std::move(root));
+
+        return result_t::s_done;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_zero(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::boolean_t
+    JSON_TEMPLATE_CLASS::lazy_value::scan_next(list_t<lazy_node>* nodes, lazy_node* node)
     {
+        if (node->complete)
+            return false;
 
-        const state_t s = state::get();
-        result_t res = result_t::s_ok;
+        const boolean_t is_object = 0x7B == *node->begin;
+        const symbol_t* const end = node->end - 1;   // the closing bracket
 
-        switch (s)
+        // the root is checked by the parse, the nested containers here
+        if ((is_object ? 0x7D : 0x5D) != *end || end == node->begin)
+            throw std::logic_error("Malformed JSON.");
+
+        const symbol_t* p = node->scan;
+        while (p < end && is_space(*p))
+            ++p;
+
+        if (p == end)
         {
-        case state_t::initial:
-        case state_t::leading_minus:
-        case state_t::integer:
-            if (!m_value)
-                m_value.emplace();
-            res = append_digit((*m_value).m_integer, c);
-            break;
-        case state_t::decimal_dot:
-        case state_t::fractional:
-            assert(m_value);
-            res = append_digit((*m_value).m_fractional_value, c);
-            break;
-        case state_t::exponent_delim:
-        case state_t::exponent_sign:
-            assert(m_value);
-        case state_t::exponent_val:
-            res = append_digit((*m_value).m_exponent_value, c);
-            break;
+            if (!node->members.empty())
+                throw std::logic_error("Malformed JSON.");  // a trailing comma
+
+            node->complete = true;
+            return false;
         }
 
-        return result_t::s_ok == res ? result_t::s_need_more : res;
-    }
+        typename lazy_node::member m;
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_dot(const symbol_t& c, const int pos)
-    {
-        return result_t::s_need_more;
-    }
+        if (is_object)
+        {
+            if (0x22 != *p)
+                throw std::logic_error("Malformed JSON.");
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_done(const symbol_t& c, const int pos)
-    {
-        return result_t::s_done_rpt;
-    }
+            const symbol_t* k = ++p;
+            for (;;)
+            {
+                p += plain_run(p, end - p);
+                if (p >= end || (0x22 != *p && 0x5C != *p))
+                    throw std::logic_error("Malformed JSON.");
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::on_fail(const symbol_t& c, const int pos)
-    {
-        return result_t::e_unexpected;
+                if (0x22 == *p)
+                    break;
+
+                m.escaped = true;
+                p += 2;
+                if (p >= end)
+                    throw std::logic_error("Malformed JSON.");
+            }
+
+            m.key = string_view(k, p - k);
+
+            ++p;
+            while (p < end && is_space(*p))
+                ++p;
+
+            if (p == end || 0x3A != *p)
+                throw std::logic_error("Malformed JSON.");
+
+            ++p;
+            while (p < end && is_space(*p))
+                ++p;
+        }
+
+        // the value goes up to the next comma or the closing bracket of the container
+        const symbol_t* d = next_delimiter(p, node->end, 0x2C);
+        if (d == node->end || (d != end && 0x2C != *d))
+            throw std::logic_error("Malformed JSON.");
+
+        const symbol_t* v = d;
+        while (v > p && is_space(*(v - 1)))
+            --v;
+
+        if (v == p)
+            throw std::logic_error("Malformed JSON.");
+
+        lazy_node child;
+        child.begin = p;
+        child.end = v;
+        child.scan = p + 1;
+        nodes->push_back(std::move(child));
+
+        m.node = &nodes->back();
+        node->members.push_back(m);
+
+        node->scan = d + 1;
+        node->complete = d == end;
+
+        return true;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::number_parser_t::append_digit(integer_t& val, const symbol_t& c)
+    typename JSON_TEMPLATE_CLASS::lazy_node*
+    JSON_TEMPLATE_CLASS::lazy_value::find(const string& key) const
     {
-        if (c < 0x30 || 0x39 < c)
-            return result_t::e_fatal;
+        if (!is_object())
+            throw std::logic_error("Not an object.");
 
-        val *= 10;
+        auto matches = [&key](const typename lazy_node::member& m)->boolean_t
+        {
+            if (!m.escaped)
+                return m.key.size() == key.size() && std::equal(m.key.begin(), m.key.end(), key.begin());
 
-        switch (c)
+            string decoded;
+            return succeded(decode_string(m.key.data(), m.key.data() + m.key.size(), decoded)) && decoded == key;
+        };
+
+        // the members found so far, then the rest of the text
+        for (const auto& m : m_node->members)
         {
-        case 0x31: val += 1; break; //1
-        case 0x32: val += 2; break; //2
-        case 0x33: val += 3; break; //3
-        case 0x34: val += 4; break; //4
-        case 0x35: val += 5; break; //5
-        case 0x36: val += 6; break; //6
-        case 0x37: val += 7; break; //7
-        case 0x38: val += 8; break; //8
-        case 0x39: val += 9; break; //9
+            if (matches(m))
+                return m.node;
         }
-
-        return result_t::s_ok;
-    };
-    #pragma endregion
-    //
-    #pragma region -- null parser definition -- 
-    JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::null_parser_t::reset()
-    {
-        state::set(state_t::initial);
-        m_value.reset();
+
+        while (scan_next(m_nodes, m_node))
+        {
+            if (matches(m_node->members.back()))
+                return m_node->members.back().node;
+        }
+
+        return nullptr;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::putchar(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::lazy_value::scalar() const
     {
-        return parser_impl::step(to_event(c), c, pos);
+        value v;
+        if (failed(decode_scalar(m_node->begin, m_node->end, v)))
+            throw std::logic_error("Malformed JSON.");
+
+        return v;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::null_parser_t::get() const
+    typename JSON_TEMPLATE_CLASS::value::vt
+    JSON_TEMPLATE_CLASS::lazy_value::index() const
     {
-        if (m_value)
-            return *m_value;
+        switch (*m_node->begin)
+        {
+        case 0x22: // "
+            return value::vt::t_string;
+        case 0x7B: // {
+            return value::vt::t_object;
+        case 0x5B: // [
+            return value::vt::t_array;
+        case 0x74: // t
+        case 0x66: // f
+            return value::vt::t_boolean;
+        case 0x6E: // n
+            return value::vt::t_null;
+        }
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
+        return scalar().index();
+    }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::null_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::null_parser_t::table()
+    typename JSON_TEMPLATE_CLASS::lazy_value
+    JSON_TEMPLATE_CLASS::lazy_value::operator[](const string& key) const
     {
-        return m_event_2_state_table;
+        lazy_node* n = find(key);
+        if (nullptr == n)
+            throw std::out_of_range("No such member.");
+
+        return lazy_value(m_nodes, n);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::null_parser_t::event_t
-    JSON_TEMPLATE_CLASS::null_parser_t::to_event(const symbol_t& c) const
+    typename JSON_TEMPLATE_CLASS::lazy_value
+    JSON_TEMPLATE_CLASS::lazy_value::operator[](const size_t idx) const
     {
-        switch (c)
+        if (!is_array())
+            throw std::logic_error("Not an array.");
+
+        while (m_node->members.size() <= idx)
         {
-        case 0x6e:
-            return event_t::letter_n;
-        case 0x75:
-            return event_t::letter_u;
-        case 0x6c:
-            return event_t::letter_l;
+            if (!scan_next(m_nodes, m_node))
+                throw std::out_of_range("No such element.");
         }
 
-        return event_t::other;
+        return lazy_value(m_nodes, m_node->members[idx].node);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::null_parser_t::event_t
-    JSON_TEMPLATE_CLASS::null_parser_t::to_event(const result_t& c) const
+    typename JSON_TEMPLATE_CLASS::boolean_t
+    JSON_TEMPLATE_CLASS::lazy_value::exists(const string& key) const
     {
-        return event_t::other;
+        return nullptr != find(key);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::on_n(const symbol_t& c, const int pos)
+    size_t JSON_TEMPLATE_CLASS::lazy_value::size() const
     {
-        return result_t::s_need_more;
+        if (!is_object() && !is_array())
+            throw std::logic_error("Not a container.");
+
+        while (scan_next(m_nodes, m_node));
+
+        return m_node->members.size();
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::on_u(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::lazy_value::iterator
+    JSON_TEMPLATE_CLASS::lazy_value::begin() const
     {
-        return result_t::s_need_more;
+        if (!is_object() && !is_array())
+            throw std::logic_error("Not a container.");
+
+        return iterator(m_nodes, m_node, 0);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::on_l(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::lazy_value::iterator
+    JSON_TEMPLATE_CLASS::lazy_value::end() const
     {
-        return result_t::s_need_more;
+        return iterator(m_nodes, m_node, SIZE_MAX);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::on_done(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::value
+    JSON_TEMPLATE_CLASS::lazy_value::to_value() const
     {
-        if (!m_value)
-            m_value.emplace();
+        value v;
+        if (result_t::s_done != parse(m_node->begin, m_node->end - m_node->begin, v, options{ engine_t::flat }))
+            throw std::logic_error("Malformed JSON.");
 
-        (*m_value) = nullptr;
+        return v;
+    }
 
-        return result_t::s_done;
-    };
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::lazy_value::operator string() const
+    {
+        if (!is_string())
+            throw std::logic_error("Not a string.");
+
+        string str;
+        if (m_node->end - m_node->begin < 2 || 0x22 != *(m_node->end - 1) ||
+            failed(decode_string(m_node->begin + 1, m_node->end - 1, str)))
+            throw std::logic_error("Malformed JSON.");
+
+        return str;
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::null_parser_t::on_fail(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::lazy_value::operator int64_t() const
     {
-        return result_t::e_unexpected;
+        const value v = scalar();
+        if (!v.is_integer())
+            throw std::logic_error("Not an integer number.");
+
+        return (int64_t)v.get<integer_t>();
     }
-    #pragma endregion
-    //
-    #pragma region -- bool parser definition -- 
+
     JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::bool_parser_t::reset()
+    JSON_TEMPLATE_CLASS::lazy_value::operator floatingpt_t() const
     {
-        state::set(state_t::initial);
-        m_str.clear();
-        m_value.reset();
-    };
+        const value v = scalar();
+        if (!v.is_floatingpt())
+            throw std::logic_error("Not a floating pointer number.");
+
+        return v.get<floatingpt_t>();
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::putchar(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::lazy_value::operator boolean_t() const
     {
-        return parser_impl::step(to_event(c), c, pos);
-    };
+        const value v = scalar();
+        if (!v.is_boolean())
+            throw std::logic_error("Not a boolean.");
+
+        return v.get<boolean_t>();
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::bool_parser_t::get() const
+    JSON_TEMPLATE_CLASS::lazy_value::operator null_t() const
     {
-        if (m_value)
-            return *m_value;
+        const value v = scalar();
+        if (!v.is_null())
+            throw std::logic_error("Not a null.");
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
+        return v.get<null_t>();
+    }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::bool_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::bool_parser_t::table()
+    JSON_TEMPLATE_CLASS::lazy_value::iterator::iterator(list_t<lazy_node>* nodes, lazy_node* node, const size_t idx)
+        : m_nodes(nodes)
+        , m_node(node)
+        , m_idx(idx)
     {
-        return m_event_2_state_table;
+        // the end unless the member is there
+        if (SIZE_MAX != m_idx && m_node->members.size() <= m_idx && !scan_next(m_nodes, m_node))
+            m_idx = SIZE_MAX;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::bool_parser_t::event_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::to_event(const symbol_t& c) const
+    typename JSON_TEMPLATE_CLASS::string
+    JSON_TEMPLATE_CLASS::lazy_value::iterator::key() const
     {
-        switch (c)
-        {
-        case 0x61:
-            return event_t::letter_a;
-        case 0x65:
-            return event_t::letter_e;
-        case 0x66:
-            return event_t::letter_f;
-        case 0x6c:
-            return event_t::letter_l;
-        case 0x72:
-            return event_t::letter_r;
-        case 0x73:
-            return event_t::letter_s;
-        case 0x74:
-            return event_t::letter_t;
-        case 0x75:
-            return event_t::letter_u;
-        }
-        return event_t::symbol;
-    };
+        const typename lazy_node::member& m = m_node->members[m_idx];
+
+        string key;
+        if (!m.escaped)
+            key.assign(m.key.data(), m.key.size());
+        else if (failed(decode_string(m.key.data(), m.key.data() + m.key.size(), key)))
+            throw std::logic_error("Malformed JSON.");
+
+        return key;
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::bool_parser_t::event_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::to_event(const result_t& c) const
+    typename JSON_TEMPLATE_CLASS::lazy_value
+    JSON_TEMPLATE_CLASS::lazy_value::iterator::operator*() const
     {
-        return event_t::symbol;
-    };
+        return lazy_value(m_nodes, m_node->members[m_idx].node);
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_t(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::lazy_value::iterator&
+    JSON_TEMPLATE_CLASS::lazy_value::iterator::operator++()
     {
-        m_str += c;
-        return result_t::s_need_more;
+        *this = iterator(m_nodes, m_node, m_idx + 1);
+        return *this;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_r(const symbol_t& c, const int pos)
+    bool JSON_TEMPLATE_CLASS::lazy_value::iterator::operator==(const iterator& other) const
     {
-        m_str += c;
-        return result_t::s_need_more;
+        return m_node == other.m_node && m_idx == other.m_idx;
+    }
+    #pragma endregion
+    //
+    #pragma region -- projection definition --
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::projection::projection(std::initializer_list<string> paths)
+        : m_steps(1)
+    {
+        for (const string& path : paths)
+            add(path);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_u(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::projection::projection(const vector_t<string>& paths)
+        : m_steps(1)
     {
-        m_str += c;
-        return result_t::s_need_more;
+        for (const string& path : paths)
+            add(path);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_f(const symbol_t& c, const int pos)
+    void JSON_TEMPLATE_CLASS::projection::add(const string& path)
     {
-        m_str += c;
-        return result_t::s_need_more;
+        if (!path.empty() && 0x2F != path[0])
+            throw std::invalid_argument("Not a JSON pointer.");
+
+        size_t n = 0;
+        for (size_t i = 0; i < path.size();)
+        {
+            // the token up to the next slash, ~1 stands for / and ~0 for ~
+            string token;
+            for (++i; i < path.size() && 0x2F != path[i]; ++i)
+            {
+                if (0x7E != path[i])
+                {
+                    token.push_back(path[i]);
+                    continue;
+                }
+
+                if (i + 1 == path.size() || (0x30 != path[i + 1] && 0x31 != path[i + 1]))
+                    throw std::invalid_argument("Not a JSON pointer.");
+
+                token.push_back(0x30 == path[++i] ? 0x7E : 0x2F);
+            }
+
+            auto it = std::find_if(m_steps[n].children.begin(), m_steps[n].children.end(),
+                                   [&token](const pair_t<string, size_t>& c) { return c.first == token; });
+            if (it != m_steps[n].children.end())
+            {
+                n = it->second;
+                continue;
+            }
+
+            // an array index has no leading zeros
+            if (!token.empty() && token.size() < 20 && (1 == token.size() || 0x30 != token[0]) &&
+                std::all_of(token.begin(), token.end(), [](const symbol_t& c) { return 0x30 <= c && c <= 0x39; }))
+                m_steps[n].indices.emplace_back((size_t)strtoull(token.c_str(), nullptr, 10), m_steps.size());
+
+            m_steps[n].children.emplace_back(token, m_steps.size());
+            n = m_steps.size();
+            m_steps.emplace_back();
+        }
+
+        m_steps[n].paths.push_back(m_size++);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_a(const symbol_t& c, const int pos)
+    size_t JSON_TEMPLATE_CLASS::projection::child(const size_t n, const symbol_t* key, const size_t len) const
     {
-        m_str += c;
-        return result_t::s_need_more;
+        for (const auto& c : m_steps[n].children)
+        {
+            if (c.first.size() == len && std::equal(key, key + len, c.first.begin()))
+                return c.second;
+        }
+
+        return SIZE_MAX;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_l(const symbol_t& c, const int pos)
+    size_t JSON_TEMPLATE_CLASS::projection::child(const size_t n, const size_t idx) const
     {
-        m_str += c;
-        return result_t::s_need_more;
+        for (const auto& c : m_steps[n].indices)
+        {
+            if (c.first == idx)
+                return c.second;
+        }
+
+        return SIZE_MAX;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_s(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::projection::extract(const symbol_t* data, const size_t len, vector_t<value>& values) const
     {
-        m_str += c;
-        return result_t::s_need_more;
+        values.assign(m_size, value(null_t()));
+
+        size_t remaining = 0;
+        for (const step& s : m_steps)
+            remaining += s.paths.empty() ? 0 : 1;
+
+        walk_state st{ data + len, values, vector_t<boolean_t>(m_steps.size(), false), remaining, string() };
+
+        const symbol_t* p = data;
+        while (p < st.end && is_space(*p))
+            ++p;
+
+        if (p == st.end)
+            return result_t::s_need_more;
+
+        const result_t r = walk(st, p, 0);
+        if (result_t::s_ok != r)
+            return r;
+
+        // the rest of the document is not looked at once everything is found
+        if (0 == st.remaining)
+            return result_t::s_done;
+
+        while (p < st.end && is_space(*p))
+            ++p;
+
+        return p == st.end ? result_t::s_done : result_t::e_unexpected;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_done(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::projection::walk(walk_state& st, const symbol_t*& p, const size_t n) const
     {
-        m_str += c;
+        const step& s = m_steps[n];
 
-        auto update = [this](const boolean_t val)->result_t 
+        // the value ends by the delimiter of the enclosing container or by the end of the document
+        auto value_end = [&st](const symbol_t* v)->const symbol_t*
         {
-            if (!m_value)
-                m_value.emplace();
-
-            (*m_value) = val;
+            const symbol_t* e = next_delimiter(v, st.end, 0x2C);
+            while (e > v && is_space(*(e - 1)))
+                --e;
+            return e;
+        };
 
-            return result_t::s_done;
+        auto skip_space = [&st](const symbol_t*& q)
+        {
+            while (q < st.end && is_space(*q))
+                ++q;
         };
 
-        if (m_str == "true")
-            return update(true);
-        if (m_str == "false")
-            return update(false);
+        if (!s.paths.empty() && !st.done[n])
+        {
+            const symbol_t* e = value_end(p);
 
-        assert(0);
+            value v;
+            const result_t r = parse(p, e - p, v, options{ engine_t::flat });
+            if (result_t::s_done != r)
+                return failed(r) ? r : result_t::e_unexpected;
 
-        return result_t::e_unexpected;
+            p = e;
+            resolve(st, v, n);
+            return result_t::s_ok;
+        }
+
+        if (s.children.empty() || (0x7B != *p && 0x5B != *p))
+        {
+            p = value_end(p);
+            return result_t::s_ok;
+        }
+
+        const boolean_t is_object = 0x7B == *p;
+        const symbol_t closing = is_object ? 0x7D : 0x5D;
+
+        ++p;
+        skip_space(p);
+        if (p < st.end && closing == *p)
+        {
+            ++p;
+            return result_t::s_ok;
+        }
+
+        for (size_t idx = 0;; ++idx)
+        {
+            size_t c = SIZE_MAX;
+
+            if (is_object)
+            {
+                if (p == st.end)
+                    return result_t::s_need_more;
+
+                if (0x22 != *p)
+                    return result_t::e_unexpected;
+
+                // the key is compared raw unless it has escapes
+                const symbol_t* k = ++p;
+                boolean_t plain = true;
+                for (;;)
+                {
+                    p += plain_run(p, st.end - p);
+                    if (p >= st.end)
+                        return result_t::s_need_more;
+
+                    if (0x22 == *p)
+                        break;
+
+                    if (0x5C != *p)
+                        return result_t::e_unexpected;
+
+                    plain = false;
+                    p += 2;
+                    if (p >= st.end)
+                        return result_t::s_need_more;
+                }
+
+                if (plain)
+                {
+                    c = child(n, k, p - k);
+                }
+                else
+                {
+                    const result_t r = decode_string(k, p, st.key);
+                    if (failed(r))
+                        return r;
+
+                    c = child(n, st.key.data(), st.key.size());
+                }
+
+                ++p;
+                skip_space(p);
+                if (p == st.end || 0x3A != *p)
+                    return p == st.end ? result_t::s_need_more : result_t::e_unexpected;
+
+                ++p;
+            }
+            else
+            {
+                c = child(n, idx);
+            }
+
+            skip_space(p);
+            if (p == st.end)
+                return result_t::s_need_more;
+
+            if (SIZE_MAX != c)
+            {
+                const result_t r = walk(st, p, c);
+                if (result_t::s_ok != r || 0 == st.remaining)
+                    return r;
+            }
+            else
+            {
+                p = value_end(p);
+            }
+
+            skip_space(p);
+            if (p == st.end)
+                return result_t::s_need_more;
+
+            if (0x2C == *p)
+            {
+                ++p;
+                skip_space(p);
+                continue;
+            }
+
+            if (closing != *p)
+                return result_t::e_unexpected;
+
+            ++p;
+            return result_t::s_ok;
+        }
+    }
+
+    JSON_TEMPLATE_PARAMS
+    void JSON_TEMPLATE_CLASS::projection::resolve(walk_state& st, const value& v, const size_t n) const
+    {
+        const step& s = m_steps[n];
+
+        if (!st.done[n] && !s.paths.empty())
+        {
+            for (const size_t path : s.paths)
+                st.values[path] = v;
+
+            st.done[n] = true;
+            --st.remaining;
+        }
+
+        // the paths going deeper than the one extracted, i.e. "/a/b" with "/a"
+        if (v.is_object() && !s.children.empty())
+        {
+#if _HAS_CXX17
+            const obj& o = std::get<obj>(v);
+#else
+            const obj& o = boost::get<obj>(v);
+#endif
+            for (const auto& c : s.children)
+            {
+                auto it = o.find(c.first);
+                if (it != o.end())
+                    resolve(st, it->second, c.second);
+            }
+        }
+        else if (v.is_array() && !s.indices.empty())
+        {
+#if _HAS_CXX17
+            const arr& a = std::get<arr>(v);
+#else
+            const arr& a = boost::get<arr>(v);
+#endif
+            for (const auto& c : s.indices)
+            {
+                if (c.first < a.size())
+                    resolve(st, a[c.first], c.second);
+            }
+        }
     }
-
+    #pragma endregion
+    //
+    #pragma region -- intern table definition --
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::bool_parser_t::on_fail(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::intern_table::intern_table(const size_t capacity)
+        : m_mask([capacity]() { size_t n = 16; while (n < capacity) n *= 2; return n - 1; }())
+        , m_limit((m_mask + 1) / 4 * 3)
+        , m_slots(new std::atomic<const atom*>[m_mask + 1])
+        , m_size(0)
     {
-        return result_t::e_unexpected;
+        for (size_t i = 0; i <= m_mask; ++i)
+            m_slots[i].store(nullptr, std::memory_order_relaxed);
     }
-    #pragma endregion
-    //
-    #pragma region -- value parser definition --
+
     JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::value_parser_t::reset()
+    JSON_TEMPLATE_CLASS::intern_table::~intern_table()
     {
-        state::set(state_t::initial);
-        for (ParserItem_t& p : parsing_unit)
-            p.first = true, p.second->reset();
-    };
+        for (size_t i = 0; i <= m_mask; ++i)
+            ::operator delete(const_cast<atom*>(m_slots[i].load(std::memory_order_relaxed)));
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::value_parser_t::putchar(const symbol_t& c, const int pos)
+    const typename JSON_TEMPLATE_CLASS::intern_table::atom*
+    JSON_TEMPLATE_CLASS::intern_table::find(const string_view& str) const
     {
-        result_t r = parser_impl::step(to_event(c), c, pos);
+        const uint64_t h = hash(str);
 
-        if (state::get() == state_t::read && (result_t::s_done == r || result_t::s_done_rpt == r))
+        for (size_t i = (size_t)h & m_mask, probes = 0; probes <= m_mask; i = (i + 1) & m_mask, ++probes)
         {
-            result_t new_r = parser_impl::step(to_event(r), c, pos);
-            assert(result_t::s_done == new_r);
-            return  r != new_r ? r : new_r;
+            const atom* const a = m_slots[i].load(std::memory_order_acquire);
+            if (nullptr == a)
+                break;
+
+            if (h == a->hash && str == a->view())
+                return a;
         }
 
-        return r;
-    };
+        return nullptr;
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::value_parser_t::get() const
+    const typename JSON_TEMPLATE_CLASS::intern_table::atom*
+    JSON_TEMPLATE_CLASS::intern_table::intern(const string_view& str)
     {
-        for (auto cit = parsing_unit.cbegin(); cit != parsing_unit.cend(); ++cit)
+        const uint64_t h = hash(str);
+        atom* candidate = nullptr;
+
+        for (size_t i = (size_t)h & m_mask, probes = 0; probes <= m_mask; i = (i + 1) & m_mask, ++probes)
         {
-            if (true == cit->first)
+            const atom* a = m_slots[i].load(std::memory_order_acquire);
+            if (nullptr == a)
+            {
+                if (m_size.load(std::memory_order_relaxed) >= m_limit)
+                    break;
+
+                if (nullptr == candidate)
+                {
+                    candidate = static_cast<atom*>(::operator new(sizeof(atom) + str.size() * sizeof(symbol_t)));
+                    candidate->hash = h;
+                    candidate->size = str.size();
+                    memcpy(candidate + 1, str.data(), str.size() * sizeof(symbol_t));
+                }
+
+                // publishes the atom, on failure a holds the one of the winner
+                if (m_slots[i].compare_exchange_strong(a, candidate, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    m_size.fetch_add(1, std::memory_order_relaxed);
+                    return candidate;
+                }
+            }
+
+            if (h == a->hash && str == a->view())
             {
-                return cit->second->get();
+                ::operator delete(candidate);
+                return a;
             }
         }
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
-
+        ::operator delete(candidate);
+        return nullptr;
+    }
+    #pragma endregion
+    //
+    #pragma region -- tape definition --
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::value_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::value_parser_t::table()
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::tape::parse(const symbol_t* data, const size_t len, const size_t max_depth)
     {
-        return m_event_2_state_table;
-    };
+        m_entries.clear();
+        m_strings.clear();
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value_parser_t::event_t
-    JSON_TEMPLATE_CLASS::value_parser_t::to_event(const symbol_t& c) const
-    {
-        return event_t::symbol;
-    };
+        // about one entry per 8 symbols of the text
+        m_entries.reserve(len / 8 + 2);
+        m_strings.reserve(len / 2);
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value_parser_t::event_t
-    JSON_TEMPLATE_CLASS::value_parser_t::to_event(const result_t& c) const
-    {
-        switch (state::get())
+        builder_t builder(*this);
+        flat_parser_t<builder_t> parser(builder, max_depth);
+
+        const result_t result = parser.parse(data, len);
+        if (result_t::s_done != result)
         {
-        case state_t::read:
-            if (result_t::s_done == c || result_t::s_done_rpt == c)
-                return event_t::val_done;
-            break;
+            m_entries.clear();
+            m_strings.clear();
         }
 
-        return event_t::nothing;
-    };
+        return result;
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::value_parser_t::on_data(const symbol_t& c, const int pos)
+    void JSON_TEMPLATE_CLASS::tape::assign(const value& v)
     {
-        result_t res = result_t::e_fatal;
-        uint8_t parsers_in_work = 0;
+        m_entries.clear();
+        m_strings.clear();
 
-        if (parsing_unit.empty())
-        {
-            parsing_unit.push_back(ParserItem_t(true, new null_parser_t()));
-            parsing_unit.push_back(ParserItem_t(true, new bool_parser_t()));
-            parsing_unit.push_back(ParserItem_t(true, new string_parser_t()));
-            parsing_unit.push_back(ParserItem_t(true, new number_parser_t()));
-            parsing_unit.push_back(ParserItem_t(true, new array_parser_t()));
-            parsing_unit.push_back(ParserItem_t(true, new object_parser_t()));
-        }
+        builder_t builder(*this);
+        builder.replay(v);
+    }
 
-        for (std::pair<boolean_t, parser::ptr>& p : parsing_unit)
+    JSON_TEMPLATE_PARAMS
+    void JSON_TEMPLATE_CLASS::tape::builder_t::replay(const value& v)
+    {
+        switch (v.index())
+        {
+        case value::vt::t_string:
         {
-            if (true == p.first)
+            const string s = v.get<string>();
+            on_string_view(string_view(s.data(), s.size()));
+            break;
+        }
+        case value::vt::t_object:
+            on_object_begin();
+            for (const auto& member : v.get<obj>())
             {
-                result_t local_res = p.second->putchar(c, pos);
-
-                if (failed(local_res))
-                    p.first = false;
-                else if (succeded(local_res) && (failed(res) || local_res < res))
-                    res = local_res, parsers_in_work += 1;
+                on_key_view(string_view(member.first.data(), member.first.size()));
+                replay(member.second);
             }
+            on_object_end();
+            break;
+        case value::vt::t_array:
+            on_array_begin();
+            for (const value& element : v.get<arr>())
+                replay(element);
+            on_array_end();
+            break;
+        case value::vt::t_integer:
+            on_integer(v.get<integer_t>());
+            break;
+        case value::vt::t_floatingpt:
+            on_floatingpt(v.get<floatingpt_t>());
+            break;
+        case value::vt::t_boolean:
+            on_boolean(v.get<boolean_t>());
+            break;
+        case value::vt::t_null:
+            on_null();
+            break;
         }
-
-        if (0 == parsers_in_work)
-            res = result_t::e_unexpected;
-
-        return res;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::value_parser_t::on_done(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::tape::builder_t::put(const tag t, const uint64_t payload)
     {
-        return result_t::s_done;
+        m_tape.m_entries.push_back(((uint64_t)t << 56) | payload);
+        return result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::value_parser_t::on_fail(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::tape::builder_t::on_integer(const integer_t i)
     {
-        return result_t::e_unexpected;
+        static_assert(sizeof(integer_t) <= sizeof(uint64_t), "the integer must fit the tape word");
+
+        counted();
+        put(t_integer);
+        m_tape.m_entries.push_back((uint64_t)(int64_t)i);
+        return result_t::s_ok;
     }
-    #pragma endregion
-    //
-    #pragma region -- array parser definition -- 
+
     JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::array_parser_t::reset()
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::tape::builder_t::on_floatingpt(const floatingpt_t f)
     {
-        state::set(state_t::initial);
-
-        if (!m_val_parser)
-            m_val_parser.reset(new value_parser_t());
+        static_assert(sizeof(floatingpt_t) <= sizeof(uint64_t), "the floating point must fit the tape word");
 
-        m_val_parser->reset();
+        uint64_t bits = 0;
+        memcpy(&bits, &f, sizeof(f));
 
-        m_value.reset();
+        counted();
+        put(t_floatingpt);
+        m_tape.m_entries.push_back(bits);
+        return result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::putchar(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::tape::builder_t::put_string(const string_view& str, const boolean_t is_key)
     {
-        result_t r = parser_impl::step(to_event(c), c, pos);
-
-        event_t e = to_event(r);
-
-        if (event_t::nothing == e)
-            return r;
-
-        if (event_t::val_done == e)
+        if (nullptr != m_tape.m_atoms && (is_key || str.size() <= m_tape.m_short_strings))
         {
-            result_t new_r = parser_impl::step(e, c, pos);
-            r = result_t::s_need_more == new_r && result_t::s_done_rpt == r ?
-                parser_impl::step(to_event(c), c, pos) :
-                new_r;
+            const typename intern_table::atom* const a = m_tape.m_atoms->intern(str);
 
-            return r;
+            // the pointer is to fit the payload
+            if (nullptr != a && 0 == ((uint64_t)(uintptr_t)a >> 56))
+                return put(t_atom, (uint64_t)(uintptr_t)a);
         }
 
-        assert(0);
-
-        return r;
+        put(t_string, m_tape.m_strings.size());
+        m_tape.m_entries.push_back(str.size());
+        m_tape.m_strings.insert(m_tape.m_strings.end(), str.begin(), str.end());
+        return result_t::s_ok;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::array_parser_t::get() const
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::tape::builder_t::open(const tag t)
     {
-        if (m_value)
-            return *m_value;
-
-        assert(0); // TODO: throw an exception
-        return value();
+        counted();
+        m_open.push_back(m_tape.m_entries.size());
+        m_counts.push_back(0);
+        return put(t);
     }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::array_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::array_parser_t::table()
+    typename JSON_TEMPLATE_CLASS::result_t
+    JSON_TEMPLATE_CLASS::tape::builder_t::close(const tag t)
     {
-        return m_event_2_state_table;
-    }
+        const size_t begin = m_open.back();
+        const size_t end = m_tape.m_entries.size();
+        const uint64_t count = std::min<uint64_t>(m_counts.back(), 0xFFFFFF);
 
-    JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::array_parser_t::event_t
-    JSON_TEMPLATE_CLASS::array_parser_t::to_event(const symbol_t& c) const
-    {
-        auto is_space = [](const symbol_t& c)->boolean_t
-        {
-            // space, tab, cr, lf
-            return (0x20 == c || 0x09 == c || 0x0A == c || 0x0D == c);
-        };
+        if (end > 0xFFFFFFFFull)
+            return result_t::e_fatal;   // the tape indices are 32 bit
 
-        switch (state::get())
-        {
-        case state_t::initial:
-            if (0x5B == c) //[
-                return event_t::arr_begin;
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        case state_t::val_before:
-            if (0x5D == c) //]
-                return event_t::arr_end;
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        case state_t::val_after:
-            if (0x5D == c) //]
-                return event_t::arr_end;
-            if (0x2C == c) //,
-                return event_t::comma;
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        }
+        m_open.pop_back();
+        m_counts.pop_back();
 
-        return event_t::symbol;
+        m_tape.m_entries[begin] |= (uint64_t)end | (count << 32);
+        return put(t, begin);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::array_parser_t::event_t
-    JSON_TEMPLATE_CLASS::array_parser_t::to_event(const result_t& r) const
+    typename JSON_TEMPLATE_CLASS::value::vt
+    JSON_TEMPLATE_CLASS::tape::value_view::index() const
     {
-        switch (state::get())
+        switch (m_tape->tag_of(m_idx))
         {
-        case state_t::val_inside:
-            if (result_t::s_done == r || result_t::s_done_rpt == r)
-                return event_t::val_done;
-            break;
+        case t_string:
+        case t_atom:            return value::vt::t_string;
+        case t_object_begin:    return value::vt::t_object;
+        case t_array_begin:     return value::vt::t_array;
+        case t_integer:         return value::vt::t_integer;
+        case t_floatingpt:      return value::vt::t_floatingpt;
+        case t_true:
+        case t_false:           return value::vt::t_boolean;
+        default:                return value::vt::t_null;
         }
-
-        return event_t::nothing;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_more(const unsigned& c, const int pos)
+    size_t JSON_TEMPLATE_CLASS::tape::value_view::next() const
     {
-        return result_t::s_need_more;
+        switch (m_tape->tag_of(m_idx))
+        {
+        case t_object_begin:
+        case t_array_begin:
+            return m_tape->end_of(m_idx) + 1;
+        case t_string:
+        case t_integer:
+        case t_floatingpt:
+            return m_idx + 2;
+        default:
+            return m_idx + 1;
+        }
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_begin(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::tape::obj_view
+    JSON_TEMPLATE_CLASS::tape::value_view::object() const
     {
-        if (!m_val_parser)
-            m_val_parser.reset(new value_parser_t());
-
-        if (!m_value)
-            m_value.emplace();
+        if (!is_object())
+            throw std::logic_error("Not an object.");
 
-        return result_t::s_need_more;
+        return obj_view(m_tape, m_idx);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_new(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::tape::arr_view
+    JSON_TEMPLATE_CLASS::tape::value_view::array() const
     {
-        return result_t::s_need_more;
+        if (!is_array())
+            throw std::logic_error("Not an array.");
+
+        return arr_view(m_tape, m_idx);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_val(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::tape::value_view
+    JSON_TEMPLATE_CLASS::tape::value_view::operator[](const string_view& key) const
     {
-        return m_val_parser->putchar(c, pos);
+        const obj_view o = object();
+
+        auto it = o.find(key);
+        if (it == o.end())
+            throw std::out_of_range("No such member.");
+
+        return it.value();
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_got_val(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::tape::value_view
+    JSON_TEMPLATE_CLASS::tape::value_view::operator[](const size_t idx) const
     {
-        assert(m_value);
+        const arr_view a = array();
 
-        const value val = m_val_parser->get();
+        auto it = a.begin();
+        for (size_t i = 0; i < idx && it != a.end(); ++i)
+            ++it;
 
-        (*m_value).push_back(val);
-
-        m_val_parser->reset();
+        if (it == a.end())
+            throw std::out_of_range("No such element.");
 
-        return result_t::s_need_more;
+        return *it;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_done(const symbol_t& c, const int pos)
+    const typename JSON_TEMPLATE_CLASS::intern_table::atom*
+    JSON_TEMPLATE_CLASS::tape::value_view::atom() const
     {
-        assert(m_value);
+        if (t_atom != m_tape->tag_of(m_idx))
+            return nullptr;
 
-        return result_t::s_done;
+        return reinterpret_cast<const typename intern_table::atom*>((uintptr_t)m_tape->payload_of(m_idx));
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::array_parser_t::on_fail(const symbol_t& c, const int pos)
+    typename JSON_TEMPLATE_CLASS::string_view
+    JSON_TEMPLATE_CLASS::tape::value_view::str() const
     {
-        return result_t::e_unexpected;
+        if (!is_string())
+            throw std::logic_error("Not a string.");
+
+        if (t_atom == m_tape->tag_of(m_idx))
+            return atom()->view();
+
+        return string_view(m_tape->m_strings.data() + m_tape->payload_of(m_idx), (size_t)m_tape->m_entries[m_idx + 1]);
     }
-    #pragma endregion
-    //
-    #pragma region -- object parser definition --
+
     JSON_TEMPLATE_PARAMS
-    void
-    JSON_TEMPLATE_CLASS::object_parser_t::reset()
+    JSON_TEMPLATE_CLASS::tape::value_view::operator int64_t() const
     {
-        state::set(state_t::initial);
-
-        if (!m_key_parser)
-            m_key_parser.reset(new string_parser_t());
-        else
-            m_key_parser->reset();
+        if (!is_integer())
+            throw std::logic_error("Not an integer number.");
 
-        if (!m_val_parser)
-            m_val_parser.reset(new value_parser_t());
-        else
-            m_val_parser->reset();
-
-        m_value.reset();
+        return (int64_t)m_tape->m_entries[m_idx + 1];
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::putchar(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::tape::value_view::operator floatingpt_t() const
     {
-        result_t r = parser_impl::step(to_event(c), c, pos);
+        if (!is_floatingpt())
+            throw std::logic_error("Not a floating pointer number.");
 
-        event_t e = to_event(r);
-
-        if (event_t::nothing == e)
-            return r;
+        floatingpt_t f = 0;
+        memcpy(&f, &m_tape->m_entries[m_idx + 1], sizeof(f));
+        return f;
+    }
 
-        if (event_t::val_done == e || event_t::key_done == e)
-        {
-            result_t new_r = parser_impl::step(e, c, pos);
-            r = result_t::s_need_more == new_r && result_t::s_done_rpt == r ?
-                parser_impl::step(to_event(c), c, pos) :
-                new_r;
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::tape::value_view::operator boolean_t() const
+    {
+        if (!is_boolean())
+            throw std::logic_error("Not a boolean.");
 
-            return r;
-        }
+        return t_true == m_tape->tag_of(m_idx);
+    }
 
-        assert(0); // TODO: throw an exception
+    JSON_TEMPLATE_PARAMS
+    JSON_TEMPLATE_CLASS::tape::value_view::operator null_t() const
+    {
+        if (!is_null())
+            throw std::logic_error("Not a null.");
 
-        return r;
-    };
+        return null_t();
+    }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::value
-    JSON_TEMPLATE_CLASS::object_parser_t::get() const
+    JSON_TEMPLATE_CLASS::tape::value_view::to_value() const
     {
-        if (m_value)
-            return *m_value;
+        switch (index())
+        {
+        case value::vt::t_string:
+            return value((string)*this);
+        case value::vt::t_object:
+        {
+            obj o;
+            const obj_view view = object();
+            for (auto it = view.begin(); it != view.end(); ++it)
+                o[string(it.key().data(), it.key().size())] = it.value().to_value();
+            return value(std::move(o));
+        }
+        case value::vt::t_array:
+        {
+            arr a;
+            const arr_view view = array();
+            a.reserve(view.size());
+            for (auto it = view.begin(); it != view.end(); ++it)
+                a.push_back((*it).to_value());
+            return value(std::move(a));
+        }
+        case value::vt::t_integer:
+            return value((integer_t)(int64_t)*this);
+        case value::vt::t_floatingpt:
+            return value((floatingpt_t)*this);
+        case value::vt::t_boolean:
+            return value((boolean_t)*this);
+        default:
+            break;
+        }
 
-        assert(0); // TODO: throw an exception
-        return value();
-    };
+        return value(null_t());
+    }
 
     JSON_TEMPLATE_PARAMS
-    const typename JSON_TEMPLATE_CLASS::object_parser_t::EventToStateTable_t&
-    JSON_TEMPLATE_CLASS::object_parser_t::table()
+    size_t JSON_TEMPLATE_CLASS::tape::obj_view::size() const
     {
-        return m_event_2_state_table;
+        const size_t count = (size_t)(m_tape->payload_of(m_idx) >> 32);
+        if (count < 0xFFFFFF)
+            return count;
+
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+        return n;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::object_parser_t::event_t
-    JSON_TEMPLATE_CLASS::object_parser_t::to_event(const symbol_t& c) const
+    typename JSON_TEMPLATE_CLASS::tape::obj_view::iterator
+    JSON_TEMPLATE_CLASS::tape::obj_view::find(const string_view& key) const
     {
-        auto is_space = [](const symbol_t& c)->boolean_t
-        {
-            // space, tab, cr, lf
-            return (0x20 == c || 0x09 == c || 0x0A == c || 0x0D == c);
-        };
-
-        switch (state::get())
+        for (auto it = begin(); it != end(); ++it)
         {
-        case state_t::initial:
-            if (0x7B == c)  //{
-                return event_t::obj_begin;
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        case state_t::key_before:
-            if (0x7D == c)  //}
-                return event_t::obj_end;
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        case state_t::key_after:
-            if (is_space(c))
-                return event_t::skip;
-            if (0x3A == c)  //:
-                return event_t::colon;
-            break;
-        case state_t::val_before:
-            if (is_space(c))
-                return event_t::skip;
-            break;
-        case state_t::val_after:
-            if (0x7D == c)  //}
-                return event_t::obj_end;
-            if (is_space(c))
-                return event_t::skip;
-            if (0x2c == c)  //,
-                return event_t::comma;
-            break;
+            if (it.key() == key)
+                return it;
         }
 
-        return event_t::symbol;
-    };
+        return end();
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::object_parser_t::event_t
-    JSON_TEMPLATE_CLASS::object_parser_t::to_event(const result_t& r) const
+    typename JSON_TEMPLATE_CLASS::tape::obj_view::iterator
+    JSON_TEMPLATE_CLASS::tape::obj_view::find(const typename intern_table::atom* key) const
     {
-        switch (state::get())
+        if (nullptr == key)
+            return end();
+
+        for (auto it = begin(); it != end(); ++it)
         {
-        case state_t::key_inside:
-            if (result_t::s_done == r)
-                return event_t::key_done;
-            break;
-        case state_t::val_inside:
-            if (result_t::s_done == r || result_t::s_done_rpt == r)
-                return event_t::val_done;
-            break;
+            if (it.atom() == key)
+                return it;
         }
 
-        return event_t::nothing;
-    };
+        return end();
+    }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_more(const symbol_t& c, const int pos)
+    size_t JSON_TEMPLATE_CLASS::tape::arr_view::size() const
     {
-        return result_t::s_need_more;
-    }
+        const size_t count = (size_t)(m_tape->payload_of(m_idx) >> 32);
+        if (count < 0xFFFFFF)
+            return count;
 
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+        return n;
+    }
+    #pragma endregion
+    //
+    #pragma region -- arena document definition --
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_begin(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::arena_document::parse(const symbol_t* data, const size_t len, const size_t max_depth)
     {
-        if (!m_key_parser)
-            m_key_parser.reset(new string_parser_t());
+        // the tree is dropped with the arena, no destructors
+        m_root = &m_null;
+        m_arena.release();
 
-        if (!m_val_parser)
-            m_val_parser.reset(new value_parser_t());
+        arena_scope scope(m_arena);
 
-        if (!m_value)
-            m_value.emplace();
+        value* const root = new (m_arena.allocate(sizeof(value), alignof(value))) value(null_t());
 
-        return result_t::s_need_more;
+        dom_builder_t builder(*root);
+        flat_parser_t<dom_builder_t> parser(builder, max_depth);
+
+        const result_t result = parser.parse(data, len);
+        if (result_t::s_done == result)
+            m_root = root;
+
+        return result;
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_new(const symbol_t& c, const int pos)
+    void JSON_TEMPLATE_CLASS::arena_document::assign(const value& v)
     {
-        if (!m_key_parser)
-            m_key_parser.reset(new string_parser_t());
-        else
-            m_key_parser->reset();
+        arena_scope scope(m_arena);
 
-        if (!m_val_parser)
-            m_val_parser.reset(new value_parser_t());
+        // the copies made within the scope, the nested ones included, are in the arena
+        if (&m_null == m_root)
+            m_root = new (m_arena.allocate(sizeof(value), alignof(value))) value(v);
         else
-            m_val_parser->reset();
-
-        return result_t::s_need_more;
+            *m_root = value(v);
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_key(const symbol_t& c, const int pos)
+    void JSON_TEMPLATE_CLASS::arena_document::insert(const string& key, const value& v)
     {
-        return m_key_parser->putchar(c, pos);
+        if (!m_root->is_object())
+            throw std::logic_error("Not an object.");
+
+        arena_scope scope(m_arena);
+#if _HAS_CXX17
+        std::get<obj>(*m_root)[string(key)] = value(v);
+#else
+        boost::get<obj>(*m_root)[string(key)] = value(v);
+#endif
     }
 
     JSON_TEMPLATE_PARAMS
-    typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_val(const symbol_t& c, const int pos)
+    void JSON_TEMPLATE_CLASS::arena_document::push_back(const value& v)
     {
-        return m_val_parser->putchar(c, pos);
-    }
+        if (!m_root->is_array())
+            throw std::logic_error("Not an array.");
 
+        arena_scope scope(m_arena);
+#if _HAS_CXX17
+        std::get<arr>(*m_root).push_back(value(v));
+#else
+        boost::get<arr>(*m_root).push_back(value(v));
+#endif
+    }
+    #pragma endregion
+    //
+    #pragma region -- parallel ndjson definition --
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_done(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::parse_ndjson(const symbol_t* data, const size_t len, const std::function<void(value&&)>& on_document,
+                                      const size_t threads)
     {
-        return result_t::s_done;
+        /// A line aligned part of the buffer and its documents
+        struct chunk
+        {
+            const symbol_t*     begin   = nullptr;
+            const symbol_t*     end     = nullptr;
+            vector_t<value>     documents;
+            result_t            result  = result_t::s_done;
+            std::exception_ptr  error;
+            boolean_t           done    = false;
+        };
+
+        const size_t workers = 0 != threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
+
+        // a few chunks per thread keep the threads busy whatever the lengths of the lines are
+        const size_t min_chunk = 64 * 1024;
+        const size_t count = std::max<size_t>(1, std::min(workers * 8, len / min_chunk));
+
+        vector_t<chunk> chunks(count);
+        const symbol_t* const end = data + len;
+        for (size_t i = 0; i < count; ++i)
+        {
+            chunks[i].begin = 0 == i ? data : chunks[i - 1].end;
+            if (i + 1 == count)
+            {
+                chunks[i].end = end;
+                continue;
+            }
+
+            const symbol_t* split = std::max(chunks[i].begin, data + len / count * (i + 1));
+            split = std::find(split, end, (symbol_t)0x0A);
+            chunks[i].end = split == end ? end : split + 1;
+        }
+
+        // the chunks in flight, i.e. parsed ahead of the delivery, are limited so a slow callback does not get the
+        // whole input built in memory
+        const size_t in_flight = 2 * workers;
+
+        size_t next = 0;        // the next chunk to parse
+        size_t delivered = 0;   // the chunks delivered
+        std::mutex mutex;
+        std::condition_variable ready;  // a chunk is parsed
+        std::condition_variable room;   // a chunk is delivered or the parsing stops
+
+        auto work = [&chunks, &next, &delivered, &mutex, &ready, &room, count, in_flight]()
+        {
+            for (;;)
+            {
+                size_t i = 0;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    room.wait(lock, [&next, &delivered, count, in_flight]() { return next >= count || next < delivered + in_flight; });
+                    if (next >= count)
+                        break;
+
+                    i = next++;
+                }
+
+                chunk& c = chunks[i];
+
+                try
+                {
+                    value root;
+                    dom_builder_t builder(root);
+                    flat_parser_t<dom_builder_t> parser(builder);
+
+                    for (const symbol_t* line = c.begin; line < c.end;)
+                    {
+                        const symbol_t* eol = std::find(line, c.end, (symbol_t)0x0A);
+
+                        builder.reset();
+                        const result_t result = parser.parse(line, eol - line);
+
+                        if (result_t::s_done == result)
+                        {
+                            c.documents.push_back(std::move(root));
+                        }
+                        else if (!std::all_of(line, eol, [](const symbol_t& s) { return is_space(s); }))
+                        {
+                            c.result = failed(result) ? result : result_t::e_unexpected;
+                            break;
+                        }
+
+                        line = eol + 1;
+                    }
+                }
+                catch (...)
+                {
+                    // goes to the calling thread with the chunk
+                    c.error = std::current_exception();
+                    vector_t<value>().swap(c.documents);
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    c.done = true;
+                }
+                ready.notify_all();
+            }
+        };
+
+        // stops the threads, the chunks being parsed are finished
+        auto stop = [&next, &mutex, &room, count]()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                next = count;
+            }
+            room.notify_all();
+        };
+
+        vector_t<std::thread> pool;
+        result_t result = result_t::s_done;
+
+        try
+        {
+            for (size_t i = 0; i < std::min(workers, count); ++i)
+                pool.emplace_back(work);
+
+            // the documents go out in the input order as soon as their chunk is ready
+            for (size_t i = 0; i < count && result_t::s_done == result; ++i)
+            {
+                chunk& c = chunks[i];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ready.wait(lock, [&c]() { return c.done; });
+                }
+
+                if (c.error)
+                    std::rethrow_exception(c.error);
+
+                for (value& document : c.documents)
+                    on_document(std::move(document));
+
+                vector_t<value>().swap(c.documents);
+                result = c.result;
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    delivered = i + 1;
+                }
+                room.notify_all();
+            }
+        }
+        catch (...)
+        {
+            // the threads are not to outlive the chunks
+            stop();
+            for (std::thread& t : pool)
+                t.join();
+
+            throw;
+        }
+
+        // stops the threads after the error
+        stop();
+
+        for (std::thread& t : pool)
+            t.join();
+
+        return result;
     }
 
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_fail(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::parse_ndjson(const symbol_t* data, const size_t len, vector_t<value>& documents, const size_t threads)
     {
-        m_value.reset();
-        return result_t::e_unexpected;
+        return parse_ndjson(data, len, [&documents](value&& document) { documents.push_back(std::move(document)); }, threads);
     }
-
+    #pragma endregion
+    //
+    #pragma region -- parallel document definition --
     JSON_TEMPLATE_PARAMS
     typename JSON_TEMPLATE_CLASS::result_t
-    JSON_TEMPLATE_CLASS::object_parser_t::on_got_val(const symbol_t& c, const int pos)
+    JSON_TEMPLATE_CLASS::parse_parallel(const symbol_t* data, const size_t len, value& jsval, const size_t threads)
     {
-        assert(m_value);
+        /// A member aligned part of the root container and its parsed members
+        struct chunk
+        {
+            const symbol_t*     begin   = nullptr;
+            const symbol_t*     end     = nullptr;
+            vector_t<string>    keys;
+            vector_t<value>     values;
+            result_t            result  = result_t::s_done;
+            std::exception_ptr  error;  // thrown while parsing the chunk, rethrown on the calling thread
+        };
 
-        const string key = m_key_parser->get().get<string>();
-        const value val = m_val_parser->get();
+        const size_t workers = 0 != threads ? threads : std::max<size_t>(1, std::thread::hardware_concurrency());
 
-        (*m_value)[key] = val;
+        const size_t min_chunk = 64 * 1024;
+        const size_t count = std::min(workers * 8, len / min_chunk);
 
-        return result_t::s_need_more;
+        const symbol_t* const end = data + len;
+        const symbol_t* const root = std::find_if(data, end, [](const symbol_t& c) { return !is_space(c); });
+
+        if (count < 2 || root == end || (0x7B != *root && 0x5B != *root))
+            return parse(data, len, jsval, options{ engine_t::flat });
+
+        const boolean_t is_object = 0x7B == *root;
+
+        // the prescan: the members are walked by their delimiters only and grouped into chunks of about len / count
+        vector_t<chunk> chunks;
+        chunks.emplace_back();
+        chunks.back().begin = root + 1;
+
+        for (const symbol_t* p = root + 1;;)
+        {
+            const symbol_t* d = next_delimiter(p, end, 0x2C);
+            if (d == end)
+                return result_t::s_need_more;
+
+            if (0x2C == *d)
+            {
+                p = d + 1;
+                if ((size_t)(p - chunks.back().begin) < len / count)
+                    continue;
+
+                chunks.back().end = d;
+                chunks.emplace_back();
+                chunks.back().begin = p;
+                continue;
+            }
+
+            if ((is_object ? 0x7D : 0x5D) != *d || !std::all_of(d + 1, end, [](const symbol_t& c) { return is_space(c); }))
+                return result_t::e_unexpected;
+
+            chunks.back().end = d;
+            break;
+        }
+
+        // {} or []
+        if (1 == chunks.size() && std::all_of(chunks[0].begin, chunks[0].end, [](const symbol_t& c) { return is_space(c); }))
+        {
+            jsval = is_object ? value(obj()) : value(arr());
+            return result_t::s_done;
+        }
+
+        std::atomic<size_t> next(0);
+
+        auto work = [&chunks, &next, is_object]()
+        {
+            value member;
+            dom_builder_t builder(member);
+            flat_parser_t<dom_builder_t> parser(builder);
+
+            auto parse_member = [&builder, &parser](const symbol_t* begin, const symbol_t* end)
+            {
+                builder.reset();
+                const result_t result = parser.parse(begin, end - begin);
+                return result_t::s_done == result || failed(result) ? result : result_t::e_unexpected;
+            };
+
+            for (size_t i = next++; i < chunks.size(); i = next++)
+            {
+                chunk& c = chunks[i];
+
+                try
+                {
+                    for (const symbol_t* p = c.begin; p <= c.end && result_t::s_done == c.result;)
+                    {
+                        const symbol_t* d = next_delimiter(p, c.end, 0x2C);
+
+                        const symbol_t* colon = p;
+                        if (is_object)
+                        {
+                            colon = next_delimiter(p, d, 0x3A);
+                            if (colon != d && result_t::s_done != (c.result = parse_member(p, colon)))
+                                break;
+
+                            if (colon == d || !member.is_string())
+                            {
+                                c.result = result_t::e_unexpected;
+                                break;
+                            }
+
+                            c.keys.push_back(member.take<string>());
+                            ++colon;
+                        }
+
+                        if (result_t::s_done != (c.result = parse_member(colon, d)))
+                            break;
+
+                        c.values.push_back(std::move(member));
+                        p = d + 1;
+                    }
+                }
+                catch (...)
+                {
+                    // goes to the calling thread with the chunk
+                    c.error = std::current_exception();
+                }
+
+                // no need to parse the rest after an error
+                if (result_t::s_done != c.result || c.error)
+                    next = chunks.size();
+            }
+        };
+
+        vector_t<std::thread> pool;
+
+        try
+        {
+            for (size_t i = 1; i < std::min(workers, chunks.size()); ++i)
+                pool.emplace_back(work);
+
+            work();
+        }
+        catch (...)
+        {
+            // the threads are not to outlive the chunks
+            next = chunks.size();
+            for (std::thread& t : pool)
+                t.join();
+
+            throw;
+        }
+
+        for (std::thread& t : pool)
+            t.join();
+
+        // the members are moved to the root in order, the first error in the chunk order goes out
+        size_t members = 0;
+        for (const chunk& c : chunks)
+        {
+            if (c.error)
+                std::rethrow_exception(c.error);
+
+            if (result_t::s_done != c.result)
+                return c.result;
+
+            members += c.values.size();
+        }
+
+        if (is_object)
+        {
+            obj o;
+            for (chunk& c : chunks)
+            {
+                for (size_t i = 0; i < c.values.size(); ++i)
+                    o[std::move(c.keys[i])] = std::move(c.values[i]);
+            }
+
+            jsval = std::move(o);
+        }
+        else
+        {
+            arr a;
+            a.reserve(members);
+            for (chunk& c : chunks)
+            {
+                for (value& v : c.values)
+                    a.push_back(std::move(v));
+            }
+
+            jsval = std::move(a);
+        }
+
+        return result_t::s_done;
     }
-#pragma endregion
+    #pragma endregion
 }
 #undef JSON_TEMPLATE_PARAMS
 #undef JSON_TEMPLATE_CLASS
-#undef STD_BIND_TO_THIS
 
 #endif // __JSON_LIB_H__
\ No newline at end of file
@@ -2,9 +2,41 @@
 //
 #include "../json_lib/json_lib.h"
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <random>
 
 typedef imalyavskiy::json::result_t result_t;
 using json = imalyavskiy::json;
+using arena_json = imalyavskiy::arena_json;
+using pmr_json = imalyavskiy::pmr_json;
+using flat_json = imalyavskiy::flat_json;
+using hash_json = imalyavskiy::hash_json;
+
+/// The number of heap allocations made so far, counted by the replaced operator new below
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t size)
+{
+    ++g_allocations;
+
+    if (void* p = malloc(0 != size ? size : 1))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
 
 int read_file_data(const std::string& file_name, std::string& file_data)
 {
@@ -366,6 +398,2193 @@ TEST(ObjectStructureCase, test0001_ElementAccess)
     json::string _4 = (json::string)test_obj["first"]["second"]["third"][0];
 }
 
+TEST(BufferParseCase, test0000_ObjectFromBuffer)
+{
+    const char data[] = "{\"jsonrpc\":\"2.0\",\"id\":0}";
+
+    json::obj jsobj{};
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, sizeof(data) - 1, jsobj));
+    ASSERT_EQ(std::string("2.0"), (json::string)jsobj["jsonrpc"]);
+    ASSERT_EQ(0, (int64_t)jsobj["id"]);
+}
+
+TEST(BufferParseCase, test0001_ArrayRoot)
+{
+    const std::string data(" [1, \"two\", null]");
+
+    json::value jsval;
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+    ASSERT_TRUE(jsval.is_array());
+    ASSERT_EQ(3, ((json::arr)jsval).size());
+}
+
+TEST(BufferParseCase, test0002_ScalarRoots)
+{
+    json::value jsval;
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(std::string("42"), jsval));
+    ASSERT_EQ(42, (int64_t)jsval);
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(std::string("\"str\""), jsval));
+    ASSERT_EQ(std::string("str"), (json::string)jsval);
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(std::string("true"), jsval));
+    ASSERT_TRUE((bool)jsval);
+}
+
+TEST(BufferParseCase, test0003_StringView)
+{
+    const std::string_view data("{\"1\":[],\"2\":{}}");
+
+    json::obj jsobj{};
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsobj));
+    ASSERT_TRUE(jsobj.exists("2"));
+}
+
+TEST(BufferParseCase, test0004_Incomplete)
+{
+    json::obj jsobj{};
+
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"1\":[1,"), jsobj));
+}
+
+TEST(BufferParseCase, test0005_DeepDocumentAndTake)
+{
+    const size_t depth = 1000;
+    const std::string leaf(100, 'x');
+    const std::string data = std::string(depth, '[') + "{\"k\":\"" + leaf + "\"}" + std::string(depth, ']');
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+
+    const json::value* v = &jsval;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        const json::arr& a = std::get<json::arr>(*v);
+        ASSERT_EQ(1, a.size());
+        v = &a[0];
+    }
+    ASSERT_EQ(leaf, (json::string)std::get<json::obj>(*v)["k"]);
+
+    // take() moves the content out
+    json::value jsarr(json::arr{ (int64_t)1, (int64_t)2, (int64_t)3 });
+    const json::arr taken = jsarr.take<json::arr>();
+    ASSERT_EQ(3, taken.size());
+    ASSERT_EQ(0, std::get<json::arr>(jsarr).size());
+}
+
+TEST(SessionCase, test0000_EverySplitPoint)
+{
+    const std::string data(
+        "{\"id\":69,\"num\":-3.14159261e-05,\"sdp\":\"v=0\\r\\no=\\\"x\\\"\",\"list\":[true,false,null,12]}");
+
+    json::obj expected{};
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected));
+
+    for (size_t split = 0; split <= data.size(); ++split)
+    {
+        json::session s(json::create());
+
+        ASSERT_EQ(split == data.size() ? json::result_t::s_done : json::result_t::s_need_more, s.feed(data.data(), split));
+        if (split != data.size())
+            ASSERT_EQ(json::result_t::s_done, s.feed(data.data() + split, data.size() - split));
+
+        ASSERT_EQ(expected.str(), s.get().get<json::obj>().str());
+    }
+}
+
+TEST(SessionCase, test0001_FeedLimit)
+{
+    const std::string data("[1, 22, 333]");
+
+    json::session s;
+    s.limit(2);
+
+    size_t offset = 0;
+    json::result_t result = json::result_t::s_need_more;
+    while (json::result_t::s_need_more == result && offset < data.size())
+    {
+        result = s.feed(data.data() + offset, data.size() - offset);
+        ASSERT_LE(s.consumed(), 2);
+        offset += s.consumed();
+    }
+
+    ASSERT_EQ(json::result_t::s_done, result);
+    ASSERT_EQ(data.size(), offset);
+    ASSERT_EQ(3, ((json::arr)s.get()).size());
+}
+
+TEST(SessionCase, test0002_RootNumberSplitAndFinished)
+{
+    json::session s;
+
+    ASSERT_EQ(json::result_t::s_need_more, s.feed("12", 2));
+    ASSERT_EQ(json::result_t::s_need_more, s.feed("34", 2));
+    ASSERT_EQ(json::result_t::s_done, s.finish());
+    ASSERT_EQ(1234, (int64_t)s.get());
+
+    s.reset();
+
+    ASSERT_EQ(json::result_t::s_done, s.feed("5 ", 2));
+    ASSERT_EQ(1, s.consumed());
+    ASSERT_EQ(5, (int64_t)s.get());
+}
+
+TEST(DocumentReaderCase, test0000_EveryChunkSize)
+{
+    const std::string data(
+        "{\"a\":1}\n[1,2]\n\"str\"\n42\n-1.5e3\ntrue\nnull\n"   // NDJSON
+        "{\"b\":{}}[3]7 8\"x\"{}"                               // concatenated
+        "\x1E{\"c\":[]}\n\x1E" "5\n\x1E\"seq\"\n"               // RFC 7464
+        "12");
+
+    for (size_t chunk = 1; chunk <= data.size(); ++chunk)
+    {
+        std::istringstream input(data);
+        json::document_reader reader(input, chunk);
+
+        std::vector<json::value> docs;
+        json::value jsval;
+        json::result_t r;
+        while (json::result_t::s_done == (r = reader.next(jsval)))
+            docs.push_back(jsval);
+
+        ASSERT_EQ(json::result_t::s_ok, r) << chunk;
+        ASSERT_EQ(17, docs.size()) << chunk;
+        ASSERT_EQ(17, reader.count());
+        ASSERT_EQ(1, (int64_t)std::get<json::obj>(docs[0])["a"]);
+        ASSERT_EQ(2, std::get<json::arr>(docs[1]).size());
+        ASSERT_EQ("str", (json::string)docs[2]);
+        ASSERT_EQ(42, (int64_t)docs[3]);
+        ASSERT_EQ(-1500.0, (double)docs[4]);
+        ASSERT_EQ(true, (bool)docs[5]);
+        ASSERT_TRUE(docs[6].is_null());
+        ASSERT_TRUE(std::get<json::obj>(docs[7]).exists("b"));
+        ASSERT_EQ(3, (int64_t)std::get<json::arr>(docs[8])[0]);
+        ASSERT_EQ(7, (int64_t)docs[9]);
+        ASSERT_EQ(8, (int64_t)docs[10]);
+        ASSERT_EQ("x", (json::string)docs[11]);
+        ASSERT_EQ(0, std::get<json::obj>(docs[12]).size());
+        ASSERT_TRUE(std::get<json::obj>(docs[13]).exists("c"));
+        ASSERT_EQ(5, (int64_t)docs[14]);
+        ASSERT_EQ("seq", (json::string)docs[15]);
+        ASSERT_EQ(12, (int64_t)docs[16]);
+    }
+}
+
+TEST(DocumentReaderCase, test0001_BrokenRecords)
+{
+    const std::string data("{\"a\":1}\n{\"b\" 2}\n{\"c\":3}\n\x1E[1,\x1E[2]\n{\"d\":");
+
+    json::document_reader reader(data.data(), data.size());
+    json::value jsval;
+
+    ASSERT_EQ(json::result_t::s_done, reader.next(jsval));
+    ASSERT_EQ(1, (int64_t)std::get<json::obj>(jsval)["a"]);
+    ASSERT_EQ(json::result_t::e_unexpected, reader.next(jsval));
+    ASSERT_EQ(json::result_t::s_done, reader.next(jsval));
+    ASSERT_EQ(3, (int64_t)std::get<json::obj>(jsval)["c"]);
+    ASSERT_EQ(json::result_t::e_unexpected, reader.next(jsval));     // the truncated record
+    ASSERT_EQ(json::result_t::s_done, reader.next(jsval));
+    ASSERT_EQ(2, (int64_t)std::get<json::arr>(jsval)[0]);
+    ASSERT_EQ(json::result_t::s_need_more, reader.next(jsval));      // the input ends in the middle
+    ASSERT_EQ(json::result_t::s_ok, reader.next(jsval));
+    ASSERT_EQ(3, reader.count());
+}
+
+std::string make_ndjson(const size_t records)
+{
+    std::string data;
+    for (size_t i = 0; i < records; ++i)
+    {
+        data += "{\"id\":" + std::to_string(i) + ",\"tags\":[\"a\",null,true],\"rate\":" + std::to_string(i * 0.5) + "}\n";
+        if (0 == i % 100)
+            data += " \r\n";                                   // blank lines are skipped
+    }
+    return data;
+}
+
+TEST(ParallelNdjsonCase, test0000_SameAsSequential)
+{
+    const std::string data = make_ndjson(20000);
+
+    std::vector<json::value> sequential;
+    json::document_reader reader(data.data(), data.size());
+    json::value jsval;
+    while (json::result_t::s_done == reader.next(jsval))
+        sequential.push_back(jsval);
+
+    for (const size_t threads : { 1, 2, 3, 8 })
+    {
+        std::vector<json::value> parallel;
+        ASSERT_EQ(json::result_t::s_done, json::parse_ndjson(data.data(), data.size(), parallel, threads));
+        ASSERT_EQ(sequential.size(), parallel.size()) << threads;
+
+        for (size_t i = 0; i < parallel.size(); ++i)
+            ASSERT_EQ(std::get<json::obj>(sequential[i]).str(), std::get<json::obj>(parallel[i]).str()) << threads;
+    }
+}
+
+TEST(ParallelNdjsonCase, test0001_FirstBrokenLine)
+{
+    std::string data = make_ndjson(20000);
+    const size_t broken = data.find('\n', data.size() / 3) + 1;
+    data.insert(broken, "{\"id\" 1}\n");
+    data.insert(data.find('\n', data.size() / 3 * 2) + 1, "[1,\n");
+
+    for (const size_t threads : { 1, 4 })
+    {
+        size_t count = 0;
+        int64_t last = -1;
+        ASSERT_EQ(json::result_t::e_unexpected, json::parse_ndjson(data.data(), data.size(), [&count, &last](json::value&& v) {
+            ++count;
+            last = (int64_t)std::get<json::obj>(v)["id"];
+        }, threads));
+
+        // only the documents before the first broken line are delivered
+        ASSERT_EQ(std::count(data.begin(), data.begin() + broken, '{'), count);
+        ASSERT_EQ(count - 1, last);
+    }
+}
+
+TEST(ParallelNdjsonCase, test0002_CallbackThrows)
+{
+    const std::string data = make_ndjson(20000);
+
+    for (const size_t threads : { 1, 4 })
+    {
+        // the threads are stopped and joined, the exception goes to the caller
+        size_t count = 0;
+        ASSERT_THROW(json::parse_ndjson(data.data(), data.size(), [&count](json::value&&) {
+            if (++count == 5000)
+                throw std::runtime_error("stop");
+        }, threads), std::runtime_error);
+        ASSERT_EQ(5000, count);
+
+        // a slow callback gets every document in order
+        int64_t last = -1;
+        ASSERT_EQ(json::result_t::s_done, json::parse_ndjson(data.data(), data.size(), [&last](json::value&& v) {
+            const int64_t id = (int64_t)std::get<json::obj>(v)["id"];
+            ASSERT_EQ(last + 1, id);
+            last = id;
+            if (0 == id % 4000)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }, threads));
+        ASSERT_EQ(19999, last);
+    }
+}
+
+std::string make_huge_array(const size_t members)
+{
+    std::string data("[");
+    for (size_t i = 0; i < members; ++i)
+    {
+        data += 0 != i ? ",\n " : "";
+        data += "{\"id\":" + std::to_string(i) + ",\"name\":\"a,b]}\\\"[{\",\"list\":[1,[2,{\"x\":\"]\"}],3],\"ok\":true}";
+    }
+    return data + "]";
+}
+
+TEST(ParallelDocumentCase, test0000_SameAsFlat)
+{
+    std::string object("{");
+    for (size_t i = 0; i < 20000; ++i)
+        object += (0 != i ? "," : "") + std::string("\"key ") + std::to_string(i) + ",:\\\"\" : [\"" + std::to_string(i) + "\", {}, []]";
+    object += "} ";
+
+    const std::string data[] = { make_huge_array(5000), object, "[]", " { } ", "42", "[1,2]" };
+
+    for (const std::string& d : data)
+    {
+        json::value flat;
+        ASSERT_EQ(json::result_t::s_done, json::parse(d, flat, json::options{ json::engine_t::flat }));
+
+        for (const size_t threads : { 1, 2, 3, 8 })
+        {
+            json::value parallel;
+            ASSERT_EQ(json::result_t::s_done, json::parse_parallel(d.data(), d.size(), parallel, threads));
+            ASSERT_EQ(flat.index(), parallel.index());
+            if (flat.is_object())
+                ASSERT_EQ(std::get<json::obj>(flat).str(), std::get<json::obj>(parallel).str());
+            else if (flat.is_array())
+                ASSERT_EQ(std::get<json::arr>(flat).str(), std::get<json::arr>(parallel).str());
+        }
+    }
+}
+
+TEST(ParallelDocumentCase, test0001_Errors)
+{
+    const std::string data = make_huge_array(5000);
+    const size_t middle = data.find(",\n", data.size() / 2);
+
+    const std::pair<std::string, json::result_t> broken[] = {
+        { data.substr(0, data.size() - 1), json::result_t::s_need_more },               // no closing bracket
+        { data + " x", json::result_t::e_unexpected },                                 // trailing symbols
+        { data.substr(0, data.size() - 1) + "}", json::result_t::e_unexpected },       // wrong closing bracket
+        { data.substr(0, data.size() - 1) + ",]", json::result_t::e_unexpected },      // trailing comma
+        { data.substr(0, middle) + ",,\n" + data.substr(middle + 2), json::result_t::e_unexpected },
+        { data.substr(0, middle) + " 1" + data.substr(middle), json::result_t::e_unexpected },
+        { "{" + data.substr(1, data.size() - 2) + "}", json::result_t::e_unexpected }, // members without keys
+    };
+
+    for (const auto& b : broken)
+    {
+        for (const size_t threads : { 1, 4 })
+        {
+            json::value jsval;
+            ASSERT_EQ(b.second, json::parse_parallel(b.first.data(), b.first.size(), jsval, threads));
+        }
+    }
+}
+
+/// Memory resource failing every allocation after the given number of them, from any thread
+struct failing_resource : std::pmr::memory_resource
+{
+    explicit failing_resource(const size_t allocations) : left(allocations) {}
+
+    std::atomic<ptrdiff_t> left;
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if (--left < 0)
+            throw std::bad_alloc();
+
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST(ParallelDocumentCase, test0002_WorkerThrows)
+{
+    const std::string data = make_huge_array(5000);
+
+    for (const size_t threads : { 1, 4 })
+    {
+        // the workers have no resource_scope and allocate from the default resource
+        failing_resource resource(50 * 1000);
+        std::pmr::memory_resource* const prev = std::pmr::set_default_resource(&resource);
+
+        pmr_json::value jsval;
+        EXPECT_THROW(pmr_json::parse_parallel(data.data(), data.size(), jsval, threads), std::bad_alloc);
+
+        std::pmr::set_default_resource(prev);
+    }
+}
+
+TEST(FileParseCase, test0000_MappedFile)
+{
+    static_assert(sizeof(json::pos_t) == 8, "the positions must address the inputs over 2 GB");
+
+    const std::string path("json_test_file.json");
+    const std::string data = make_huge_array(1000);
+
+    std::ofstream(path, std::ios::binary) << data;
+
+    std::string file_data;
+    ASSERT_EQ(0, read_file_data(path, file_data));
+    ASSERT_EQ(data, file_data);
+
+    json::value expected;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected));
+
+    for (const json::engine_t engine : { json::engine_t::automaton, json::engine_t::structural, json::engine_t::flat })
+    {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse_file(path, jsval, json::options{ engine }));
+        ASSERT_EQ(std::get<json::arr>(expected).str(), std::get<json::arr>(jsval).str());
+    }
+
+    json::mapped_file file;
+    ASSERT_EQ(json::result_t::s_ok, file.open(path));
+    ASSERT_EQ(data.size(), file.size());
+    ASSERT_EQ(0, memcmp(data.data(), file.data(), data.size()));
+    file.close();
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "{\"a\":[1]}";
+
+    json::obj jsobj;
+    ASSERT_EQ(json::result_t::s_done, json::parse_file(path, jsobj));
+    ASSERT_EQ(1, std::get<json::arr>(jsobj["a"]).size());
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc);
+    ASSERT_EQ(json::result_t::s_need_more, json::parse_file(path, jsobj));   // empty
+
+    std::remove(path.c_str());
+    ASSERT_EQ(json::result_t::e_fatal, json::parse_file(path, jsobj));       // missing
+}
+
+TEST(BorrowedDocumentCase, test0000_ViewsIntoInput)
+{
+    const std::string data(
+        "{\"plain\":\"text\",\"esc\\\"key\":\"a\\nb\",\"list\":[\"x\",1,-2.5,true,null,{},[]],"
+        "\"nested\":{\"k\":\"\\u0041\"}}");
+
+    json::document doc;
+    ASSERT_EQ(json::result_t::s_done, doc.parse(data.data(), data.size()));
+
+    json::value expected;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected));
+    ASSERT_EQ(std::get<json::obj>(expected).str(), std::get<json::obj>(doc.root().to_value()).str());
+
+    auto inside = [&data](const json::string_view& str) {
+        return data.data() <= str.data() && str.data() + str.size() <= data.data() + data.size();
+    };
+
+    // only the escaped strings and keys are decoded
+    ASSERT_EQ(3, doc.decoded());
+    ASSERT_TRUE(inside(doc.root()["plain"].get<json::string_view>()));
+    ASSERT_TRUE(inside(doc.root()["list"][0].get<json::string_view>()));
+    ASSERT_TRUE(inside(doc.root().get<json::document::members>()[0].first));
+    ASSERT_FALSE(inside(doc.root().get<json::document::members>()[1].first));
+    ASSERT_EQ("esc\"key", doc.root().get<json::document::members>()[1].first);
+    ASSERT_EQ("a\nb", doc.root()["esc\"key"].get<json::string_view>());
+    ASSERT_EQ(-2.5, doc.root()["list"][2].get<double>());
+    ASSERT_TRUE(doc.root()["list"][4].is_null());
+    ASSERT_EQ(nullptr, doc.root().get<json::document::members>().find("none"));
+    ASSERT_THROW(doc.root()["none"], std::out_of_range);
+    ASSERT_THROW(doc.root()[(size_t)0], std::logic_error);
+
+    // the decoded strings stay in place when the document moves
+    json::document moved(std::move(doc));
+    ASSERT_EQ("A", moved.root()["nested"]["k"].get<json::string_view>());
+
+    ASSERT_EQ(json::result_t::e_unexpected, moved.parse("[\"a\" 1]", 7));
+    ASSERT_TRUE(moved.root().is_string());
+    ASSERT_EQ(0, moved.decoded());
+}
+
+TEST(BorrowedDocumentCase, test0001_MappedFile)
+{
+    const std::string path("json_test_document.json");
+    const std::string data = make_huge_array(100);
+    std::ofstream(path, std::ios::binary) << data;
+
+    json::document doc;
+    ASSERT_EQ(json::result_t::s_done, doc.parse_file(path));
+    ASSERT_EQ(100, doc.root().get<json::document::elements>().size());
+    ASSERT_EQ(100, doc.decoded());     // one escaped string per member
+    ASSERT_EQ("]", doc.root()[99]["list"][1][1]["x"].get<json::string_view>());
+
+    std::remove(path.c_str());
+    ASSERT_EQ(json::result_t::e_fatal, doc.parse_file(path));
+}
+
+TEST(StructuralEngineCase, test0000_SameTreeAsAutomaton)
+{
+    const std::string data[] = {
+        "{}",
+        "{\"1\":{},\"2\":{}}",
+        "{\"1\":[],\"2\":{}}",
+        "{\n\t\"1\": 1,\n\t\"2\": \"two\",\n\t\"3\": null,\n\t\"4\": false,\n\t\"5\": true,\n\t\"6\": [],\n\t\"5\": {}\n}",
+        "{\"array\":[-1.0,null,true,false,\"string\",[\"another string\"],{\"one\":1}]}",
+        "{\"num\":-3.14159261e-05}",
+        "{\"ok\":true,\"conference\":{\"userlist\":[\"ab3c2a18-a5cb-41d2-b4ee-66befc87728b\",\"c47d867b\"]}}",
+        "{\n \"one\":\"1\",\n \"two\": 2,\n \"three\": { \"three\" : 3.0 },\n \"four\" : [\"4\", 4.0]\n}",
+        "{\"sdp\":\"v=0\\r\\no=FreeSWITCH 1510258435 1510258436 IN IP4 54.202.245.29\\r\\ns=FreeSWITCH\\r\\nc=IN IP4 54.202.245.29\\r\\nt=0 0\\r\\n\"}",
+        "{\"escapes\":\"\\\"\\\\\\/\\b\\f\\u0041\\ud83d\\ude00\"}",
+    };
+
+    for (const std::string& d : data)
+    {
+        json::obj automaton{}, structural{};
+
+        ASSERT_EQ(json::result_t::s_done, json::parse(d, automaton));
+        ASSERT_EQ(json::result_t::s_done, json::parse(d, structural, json::options{ json::engine_t::structural }));
+        ASSERT_EQ(automaton.str(), structural.str());
+    }
+}
+
+TEST(StructuralEngineCase, test0001_EscapesAcrossBlocks)
+{
+    for (size_t shift = 0; shift < 70; ++shift)
+    {
+        const std::string data = "[\"" + std::string(shift, 'x') + "\\\\\\\"\\u0041\\u00e9\\ud83d\\ude00{\", 1]";
+
+        json::value jsval;
+
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::structural }));
+
+        const json::arr a = jsval;
+        ASSERT_EQ(2, a.size());
+        ASSERT_EQ(std::string(shift, 'x') + "\\\"A\xC3\xA9\xF0\x9F\x98\x80{", (json::string)a[0]);
+        ASSERT_EQ(1, (int64_t)a[1]);
+    }
+}
+
+TEST(StructuralEngineCase, test0002_MalformedAndIncomplete)
+{
+    const json::options opts{ json::engine_t::structural };
+    json::value jsval;
+
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{\"a\" 1}"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1 2]"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[tru]"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{} {}"), jsval, opts));
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"a\":[1,"), jsval, opts));
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("[\"abc"), jsval, opts));
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(std::string(" -12 "), jsval, opts));
+    ASSERT_EQ(-12, (int64_t)jsval);
+}
+/// Parses the array of numbers by every engine, checks they agree and returns the automaton result
+static json::arr parse_numbers(const std::string& data)
+{
+    json::value automaton, structural, flat;
+
+    EXPECT_EQ(json::result_t::s_done, json::parse(data, automaton));
+    EXPECT_EQ(json::result_t::s_done, json::parse(data, structural, json::options{ json::engine_t::structural }));
+    EXPECT_EQ(json::result_t::s_done, json::parse(data, flat, json::options{ json::engine_t::flat }));
+    EXPECT_EQ(automaton.get<json::arr>().str(), structural.get<json::arr>().str());
+    EXPECT_EQ(automaton.get<json::arr>().str(), flat.get<json::arr>().str());
+
+    return automaton.get<json::arr>();
+}
+
+TEST(NumberParserCase, test0000_CorrectRounding)
+{
+    const char* const numbers[] = {
+        "0.1", "0.3", "2.2250738585072014e-308", "4.9e-324", "1.7976931348623157e308",
+        "9007199254740993.0", "1e23", "8.589973e9", "123456789012345678901234567890e-10", "3.14159265358979323846",
+        "0.000001", "1e-7", "-2.5e+3", "2.0", "5e-324", "1e400", "1e-400", "37.7749295", "-122.4194155",
+        "1.00000000000000011102230246251565404236316680908203125", // halfway between 1 and the next double
+        "1.00000000000000011102230246251565404236316680908203126", // just above it
+    };
+
+    std::string data("[");
+    for (const char* n : numbers)
+        data += n, data += ",";
+    data.back() = ']';
+
+    const json::arr a = parse_numbers(data);
+    ASSERT_EQ(sizeof(numbers) / sizeof(numbers[0]), a.size());
+
+    for (size_t i = 0; i < a.size(); ++i)
+        ASSERT_EQ(strtod(numbers[i], nullptr), (json::floatingpt_t)a[i]) << numbers[i];
+
+    // round trip, shortened and overlong(beyond 19 digits) representations of random doubles
+    const char* const formats[] = { "%.16e", "%.15e", "%.25e" };
+    std::mt19937_64 rng(42);
+    char buf[48];
+    data = "[";
+    std::vector<double> expected;
+    for (int i = 0; i < 30000; ++i)
+    {
+        uint64_t bits = rng();
+        double d = 0;
+        memcpy(&d, &bits, sizeof(d));
+        if (d != d || d - d != 0) // nan or inf
+            continue;
+        snprintf(buf, sizeof(buf), formats[i % 3], d);
+        expected.push_back(strtod(buf, nullptr));
+        data += buf, data += ",";
+    }
+    data.back() = ']';
+
+    const json::arr r = parse_numbers(data);
+    ASSERT_EQ(expected.size(), r.size());
+    for (size_t i = 0; i < r.size(); ++i)
+        ASSERT_EQ(expected[i], (json::floatingpt_t)r[i]) << i;
+}
+
+TEST(NumberParserCase, test0001_IntegerRangeAndExponents)
+{
+    const json::arr a = parse_numbers(
+        "[9223372036854775807,-9223372036854775808,9223372036854775808,-9223372036854775809,"
+        "123456789012345678901,0,-0,1e5,1E+2,0e0,1.5e5,25e-1,-0.0]");
+
+    ASSERT_EQ(13, a.size());
+    ASSERT_EQ(INT64_MAX, (json::integer_t)a[0]);
+    ASSERT_EQ(INT64_MIN, (json::integer_t)a[1]);
+    ASSERT_EQ(9223372036854775808.0, (json::floatingpt_t)a[2]);
+    ASSERT_EQ(-9223372036854775809.0, (json::floatingpt_t)a[3]);
+    ASSERT_EQ(123456789012345678901.0, (json::floatingpt_t)a[4]);
+    ASSERT_EQ(0, (json::integer_t)a[5]);
+    ASSERT_EQ(0, (json::integer_t)a[6]);
+    ASSERT_EQ(1e5, (json::floatingpt_t)a[7]);
+    ASSERT_EQ(100.0, (json::floatingpt_t)a[8]);
+    ASSERT_EQ(0.0, (json::floatingpt_t)a[9]);
+    ASSERT_EQ(150000.0, (json::floatingpt_t)a[10]);
+    ASSERT_EQ(2.5, (json::floatingpt_t)a[11]);
+    ASSERT_TRUE(std::signbit((json::floatingpt_t)a[12]));
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1e]"), jsval));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1.e5]"), jsval));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[01]"), jsval));
+}
+
+/// Builds the array of JSON-RPC messages of about the given size
+static std::string make_rpc_batch(const size_t size)
+{
+    const std::string message =
+        "{\"jsonrpc\":\"2.0\",\"id\":69,\"method\":\"verto.media\",\"params\":"
+        "{\"callID\":\"3c2b1fae-7665-40e6-b4e1-e61f1b738e8d\",\"sdp\":\"v=0\\r"
+        "\\no=FreeSWITCH 1510258435 1510258436 IN IP4 54.202.245.29\\r\\ns=Fre"
+        "eSWITCH\\r\\nc=IN IP4 54.202.245.29\\r\\nt=0 0\\r\\n\",\"flags\":[true,false,null],"
+        "\"rate\":48000,\"ptime\":20.5}}";
+
+    std::string batch("[");
+    while (batch.size() < size)
+        batch += message, batch += ",";
+    batch.back() = ']';
+
+    return batch;
+}
+
+TEST(FlatEngineCase, test0000_SameTreeAsAutomaton)
+{
+    const json::options opts{ json::engine_t::flat };
+
+    const std::string data[] = {
+        "{}",
+        "{\"1\":{},\"2\":{}}",
+        "{\"1\":[],\"2\":{}}",
+        "{\n\t\"1\": 1,\n\t\"2\": \"two\",\n\t\"3\": null,\n\t\"4\": false,\n\t\"5\": true,\n\t\"6\": [],\n\t\"5\": {}\n}",
+        "{\"array\":[-1.0,null,true,false,\"string\",[\"another string\"],{\"one\":1}]}",
+        "{\"num\":-3.14159261e-05}",
+        "{\n \"one\":\"1\",\n \"two\": 2,\n \"three\": { \"three\" : 3.0 },\n \"four\" : [\"4\", 4.0]\n}",
+        "{\"escapes\":\"\\\"\\\\\\/\\b\\f\\u0041\\ud83d\\ude00\"}",
+        make_rpc_batch(16 * 1024),
+    };
+
+    for (const std::string& d : data)
+    {
+        json::value automaton, flat;
+
+        ASSERT_EQ(json::result_t::s_done, json::parse(d, automaton));
+        ASSERT_EQ(json::result_t::s_done, json::parse(d, flat, opts));
+        ASSERT_EQ(automaton.index(), flat.index());
+        ASSERT_EQ(automaton.is_object() ? automaton.get<json::obj>().str() : automaton.get<json::arr>().str(),
+                  flat.is_object() ? flat.get<json::obj>().str() : flat.get<json::arr>().str());
+    }
+
+    json::obj jsobj;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data[4], jsobj, opts));
+    ASSERT_EQ(7, ((json::arr)jsobj["array"]).size());
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1]"), jsobj, opts));
+}
+
+TEST(FlatEngineCase, test0001_DepthLimit)
+{
+    const size_t depth = 10000;
+    const std::string deep = std::string(depth, '[') + std::string(depth, ']');
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::s_done, json::parse(deep, jsval, json::options{ json::engine_t::flat }));
+    ASSERT_EQ(json::result_t::s_done, json::parse(deep, jsval, json::options{ json::engine_t::flat, depth }));
+    ASSERT_EQ(json::result_t::e_depth_limit, json::parse(deep, jsval, json::options{ json::engine_t::flat, depth - 1 }));
+
+    // fails at the first symbol beyond the limit, the rest of the text is not looked at
+    ASSERT_EQ(json::result_t::e_depth_limit, json::parse(std::string("{\"a\":[{\"b\":[1]}] junk"), jsval,
+                                                         json::options{ json::engine_t::flat, 3 }));
+}
+
+TEST(FlatEngineCase, test0002_MalformedAndIncomplete)
+{
+    const json::options opts{ json::engine_t::flat };
+    json::value jsval;
+
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{\"a\" 1}"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1 2]"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[tru]"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{} {}"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[1}"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{1:2}"), jsval, opts));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[\"a\nb\"]"), jsval, opts));
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"a\":[1,"), jsval, opts));
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("[\"abc\\"), jsval, opts));
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(std::string(" -12 "), jsval, opts));
+    ASSERT_EQ(-12, (int64_t)jsval);
+}
+
+/// Writes the events down
+struct event_log : json::event_handler
+{
+    std::string log;
+
+    json::result_t on_null()                                { log += "null "; return json::result_t::s_ok; }
+    json::result_t on_boolean(const bool b)                 { log += b ? "true " : "false "; return json::result_t::s_ok; }
+    json::result_t on_integer(const int64_t i)              { log += "i" + std::to_string(i) + " "; return json::result_t::s_ok; }
+    json::result_t on_floatingpt(const double f)            { log += "f" + std::to_string(f) + " "; return json::result_t::s_ok; }
+    json::result_t on_string(json::string& str)             { log += "s:" + str + " "; return json::result_t::s_ok; }
+    json::result_t on_key(json::string& key)                { log += "k:" + key + " "; return json::result_t::s_ok; }
+    json::result_t on_object_begin()                        { log += "{ "; return json::result_t::s_ok; }
+    json::result_t on_object_end()                          { log += "} "; return json::result_t::s_ok; }
+    json::result_t on_array_begin()                         { log += "[ "; return json::result_t::s_ok; }
+    json::result_t on_array_end()                           { log += "] "; return json::result_t::s_ok; }
+};
+
+/// Sums the "rate" members of the RPC batch, the strings are not copied
+struct rate_sum : json::event_handler
+{
+    static const bool borrows_strings = true;
+
+    json::result_t on_key_view(const json::string_view& key)   { rate = "rate" == key; return json::result_t::s_ok; }
+    json::result_t on_key(json::string&)                       { rate = false; return json::result_t::s_ok; }
+    json::result_t on_integer(const int64_t i)                 { sum += rate ? i : 0; return json::result_t::s_ok; }
+    json::result_t on_object_end()                             { return ++objects == limit ? json::result_t::e_fatal : json::result_t::s_ok; }
+
+    bool    rate    = false;
+    int64_t sum     = 0;
+    size_t  objects = 0;
+    size_t  limit   = 0;
+};
+
+TEST(EventHandlerCase, test0000_Events)
+{
+    event_log log;
+    ASSERT_EQ(json::result_t::s_done, json::parse_events(std::string("{\"a\":[1,2.5,\"s\\\"\",true,null],\"b\":{}}"), log));
+    ASSERT_EQ("{ k:a [ i1 f2.500000 s:s\" true null ] k:b { } } ", log.log);
+
+    event_log partial;
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse_events(std::string("[1,{\"a\" 2}]"), partial));
+    ASSERT_EQ("[ i1 { k:a ", partial.log);
+
+    event_log deep;
+    ASSERT_EQ(json::result_t::e_depth_limit, json::parse_events(std::string("[[[1]]]"), deep, 2));
+}
+
+TEST(EventHandlerCase, test0001_NoTree)
+{
+    const std::string batch = make_rpc_batch(1024 * 1024);
+    const size_t messages = std::count(batch.begin(), batch.end(), '{') / 2;
+
+    rate_sum handler;
+    const size_t before = g_allocations;
+    ASSERT_EQ(json::result_t::s_done, json::parse_events(batch, handler));
+
+    // the parser buffers only, whatever the document size
+    ASSERT_GE(8, g_allocations - before);
+    ASSERT_EQ(48000 * (int64_t)messages, handler.sum);
+
+    // a failed handler result stops the parsing
+    rate_sum stop;
+    stop.limit = 3;
+    ASSERT_EQ(json::result_t::e_fatal, json::parse_events(batch, stop));
+    ASSERT_EQ(3, stop.objects);
+    ASSERT_EQ(48000 * 2, stop.sum);
+}
+
+/// Writes the tokens of the reader down
+static std::string read_tokens(json::reader& reader)
+{
+    std::string log;
+    for (json::token_t t = reader.next(); json::token_t::end != t && json::token_t::error != t; t = reader.next())
+    {
+        switch (t)
+        {
+        case json::token_t::object_begin:   log += "{ "; break;
+        case json::token_t::object_end:     log += "} "; break;
+        case json::token_t::array_begin:    log += "[ "; break;
+        case json::token_t::array_end:      log += "] "; break;
+        case json::token_t::key:            log += "k:" + json::string(reader.str()) + " "; break;
+        case json::token_t::string:         log += "s:" + json::string(reader.str()) + " "; break;
+        case json::token_t::integer:        log += "i" + std::to_string(reader.integer()) + " "; break;
+        case json::token_t::floatingpt:     log += "f" + std::to_string(reader.floatingpt()) + " "; break;
+        case json::token_t::boolean:        log += reader.boolean() ? "true " : "false "; break;
+        case json::token_t::null:           log += "null "; break;
+        default:                            break;
+        }
+    }
+    return log;
+}
+
+TEST(ReaderCase, test0000_EveryChunkSize)
+{
+    const std::string data(
+        "{\"key\":\"value\",\"esc\\\"aped\":\"a\\u0041\\\\\",\"nums\":[12345678,-0.5e-3,0],\"flags\":[true,false,null],"
+        "\"empty\":{},\"list\":[]}\n[1]\n\"root\" 42");
+    const std::string expected(
+        "{ k:key s:value k:esc\"aped s:aA\\ k:nums [ i12345678 f-0.000500 i0 ] k:flags [ true false null ] "
+        "k:empty { } k:list [ ] } [ i1 ] s:root i42 ");
+
+    json::reader buffer(data.data(), data.size());
+    ASSERT_EQ(expected, read_tokens(buffer));
+    ASSERT_EQ(json::token_t::end, buffer.token());
+
+    for (size_t chunk = 1; chunk <= data.size(); ++chunk)
+    {
+        std::istringstream input(data);
+        json::reader stream(input, chunk);
+        ASSERT_EQ(expected, read_tokens(stream)) << chunk;
+        ASSERT_EQ(json::token_t::end, stream.token()) << chunk;
+    }
+}
+
+TEST(ReaderCase, test0001_Skip)
+{
+    const std::string batch = make_rpc_batch(64 * 1024);
+    const size_t messages = std::count(batch.begin(), batch.end(), '{') / 2;
+
+    for (size_t chunk : { (size_t)0, (size_t)1, (size_t)7, (size_t)4096 })
+    {
+        std::istringstream input(batch);
+        std::unique_ptr<json::reader> reader(0 == chunk ? new json::reader(batch.data(), batch.size()) : new json::reader(input, chunk));
+
+        // picks the method of every message, the parameters are skipped with their escaped strings
+        const size_t before = g_allocations;
+        size_t methods = 0;
+
+        ASSERT_EQ(json::token_t::array_begin, reader->next());
+        while (json::token_t::object_begin == reader->next())
+        {
+            while (json::token_t::key == reader->next())
+            {
+                if ("method" == reader->str())
+                {
+                    ASSERT_EQ(json::token_t::string, reader->next());
+                    ASSERT_EQ("verto.media", reader->str());
+                    ++methods;
+                }
+                else
+                {
+                    ASSERT_EQ(json::result_t::s_ok, reader->skip());
+                }
+            }
+            ASSERT_EQ(json::token_t::object_end, reader->token());
+        }
+        ASSERT_EQ(json::token_t::array_end, reader->token());
+        ASSERT_EQ(json::token_t::end, reader->next());
+        ASSERT_EQ(messages, methods);
+
+        if (0 == chunk)
+            ASSERT_EQ(0, g_allocations - before);
+    }
+
+    const std::string data("[{\"a\":[\"]}\",{\"b\":[]}],\"c\":1},2]");
+    json::reader reader(data.data(), data.size());
+    ASSERT_EQ(json::token_t::array_begin, reader.next());
+    ASSERT_EQ(json::token_t::object_begin, reader.next());
+    ASSERT_EQ(json::token_t::key, reader.next());
+    ASSERT_EQ(json::token_t::array_begin, reader.next());
+    ASSERT_EQ(3, reader.depth());
+    ASSERT_EQ(json::result_t::s_ok, reader.skip());
+    ASSERT_EQ(json::token_t::array_end, reader.token());
+    ASSERT_EQ(2, reader.depth());
+    ASSERT_EQ(json::token_t::key, reader.next());
+    ASSERT_EQ("c", reader.str());
+    ASSERT_EQ(json::token_t::integer, reader.next());
+    ASSERT_EQ(1, reader.integer());
+    ASSERT_EQ(json::token_t::object_end, reader.next());
+    ASSERT_EQ(json::token_t::integer, reader.next());
+    ASSERT_EQ(2, reader.integer());
+    ASSERT_EQ(json::token_t::array_end, reader.next());
+    ASSERT_EQ(json::token_t::end, reader.next());
+}
+
+TEST(ReaderCase, test0002_Errors)
+{
+    const std::pair<std::string, json::result_t> broken[] = {
+        { "[1,", json::result_t::s_need_more },
+        { "{\"a\":\"tex", json::result_t::s_need_more },
+        { "[1,]", json::result_t::e_unexpected },
+        { "{\"a\" 1}", json::result_t::e_unexpected },
+        { "[1}", json::result_t::e_unexpected },
+        { "[tru]", json::result_t::e_unexpected },
+        { "}", json::result_t::e_unexpected },
+    };
+
+    for (const auto& b : broken)
+    {
+        json::reader reader(b.first.data(), b.first.size());
+        read_tokens(reader);
+        ASSERT_EQ(json::token_t::error, reader.token()) << b.first;
+        ASSERT_EQ(b.second, reader.result()) << b.first;
+        ASSERT_EQ(json::token_t::error, reader.next());
+    }
+
+    const std::string truncated("{\"a\":[1,2");
+    json::reader reader(truncated.data(), truncated.size());
+    ASSERT_EQ(json::token_t::object_begin, reader.next());
+    ASSERT_EQ(json::token_t::key, reader.next());
+    ASSERT_EQ(json::token_t::array_begin, reader.next());
+    ASSERT_EQ(json::result_t::s_need_more, reader.skip());
+}
+
+TEST(LazyDocumentCase, test0000_Access)
+{
+    const std::string data(
+        " {\"id\":69,\"method\":\"verto.media\",\"params\":{\"rate\":48000,\"ptime\":20.5,\"flags\":[true,false,null],"
+        "\"sdp\":\"v=0\\r\\n\"},\"esc\\u0041ped\":\"\\\"q\\\"\",\"list\":[ 1 , [2] , {\"x\":3} ]}\n");
+
+    json::lazy_document doc;
+    ASSERT_EQ(json::result_t::s_done, doc.parse(data));
+
+    const json::lazy_value root = doc.root();
+    ASSERT_TRUE(root.is_object());
+    ASSERT_EQ("verto.media", (json::string)root["method"]);
+    ASSERT_EQ(48000, (int64_t)root["params"]["rate"]);
+    ASSERT_EQ(20.5, (double)root["params"]["ptime"]);
+    ASSERT_FALSE((bool)root["params"]["flags"][1]);
+    ASSERT_TRUE(root["params"]["flags"][2].is_null());
+    ASSERT_EQ("v=0\r\n", (json::string)root["params"]["sdp"]);
+    ASSERT_EQ(69, (int64_t)root["id"]);                         // found before
+    ASSERT_EQ("\"q\"", (json::string)root["escAped"]);
+    ASSERT_EQ(3, (int64_t)root["list"][2]["x"]);
+    ASSERT_EQ("[2]", root["list"][1].text());
+    ASSERT_TRUE(root.exists("list"));
+    ASSERT_FALSE(root.exists("none"));
+    ASSERT_EQ(5, root.size());
+
+    ASSERT_THROW(root["none"], std::out_of_range);
+    ASSERT_THROW(root["list"][3], std::out_of_range);
+    ASSERT_THROW((int64_t)root["method"], std::logic_error);
+    ASSERT_THROW(root[(size_t)0], std::logic_error);
+
+    std::string keys;
+    for (auto it = root.begin(); it != root.end(); ++it)
+        keys += it.key() + " ";
+    ASSERT_EQ("id method params escAped list ", keys);
+
+    int64_t sum = 0;
+    for (auto it = root["list"].begin(); it != root["list"].end(); ++it)
+        sum += (*it).is_integer() ? (int64_t)*it : 0;
+    ASSERT_EQ(1, sum);
+
+    json::value expected;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected, json::options{ json::engine_t::flat }));
+    ASSERT_EQ(std::get<json::obj>(expected).str(), ((json::obj)root).str());
+    ASSERT_EQ(std::get<json::obj>(expected["params"]).str(), ((json::obj)root["params"]).str());
+}
+
+TEST(LazyDocumentCase, test0001_UnusedPartsAreNotParsed)
+{
+    const std::string data("{\"a\":1,\"broken\":[1,,{\"x\" 2}],\"tail\":\"t\",\"bad\":tru}");
+
+    json::lazy_document doc;
+    ASSERT_EQ(json::result_t::s_done, doc.parse(data));
+    ASSERT_EQ("t", (json::string)doc.root()["tail"]);
+    ASSERT_THROW(doc.root()["broken"].size(), std::logic_error);
+    ASSERT_THROW((bool)doc.root()["bad"], std::logic_error);
+
+    // the escape of the key eats the closing bracket
+    const std::string escaped("{\"\\}");
+    ASSERT_EQ(json::result_t::s_done, doc.parse(escaped));
+    ASSERT_THROW(doc.root()["a"], std::logic_error);
+
+    // the nested container ends by the wrong bracket
+    const std::string mismatched("[{\"a\":1]]");
+    ASSERT_EQ(json::result_t::s_done, doc.parse(mismatched));
+    ASSERT_TRUE(doc.root()[(size_t)0].is_object());
+    ASSERT_THROW(doc.root()[(size_t)0]["a"], std::logic_error);
+    ASSERT_THROW(doc.root()[(size_t)0].size(), std::logic_error);
+
+    // no document after the failed parse
+    const std::string space(" ");
+    ASSERT_EQ(json::result_t::s_need_more, doc.parse(space));
+    ASSERT_TRUE(doc.empty());
+    ASSERT_THROW(doc.root(), std::logic_error);
+    const std::string incomplete("{\"a\":1");
+    ASSERT_EQ(json::result_t::s_need_more, doc.parse(incomplete));
+    ASSERT_TRUE(doc.empty());
+    ASSERT_TRUE(json::lazy_document().empty());
+    ASSERT_THROW(json::lazy_document().root(), std::logic_error);
+
+    // the document refers to the input, it is to outlive the access
+    const std::string trailing_comma("[1,]");
+    ASSERT_EQ(json::result_t::s_done, doc.parse(trailing_comma));
+    ASSERT_THROW(doc.root().size(), std::logic_error);
+    const std::string empty("[]");
+    ASSERT_EQ(json::result_t::s_done, doc.parse(empty));
+    ASSERT_FALSE(doc.empty());
+    ASSERT_EQ(0, doc.root().size());
+    ASSERT_TRUE(doc.root().begin() == doc.root().end());
+}
+
+TEST(ProjectionCase, test0000_Paths)
+{
+    const std::string data(
+        "{\"jsonrpc\":\"2.0\",\"id\":69,\"result\":{\"sessid\":\"abc\",\"list\":[{\"a\":1},{\"a\":[2,3]}]},"
+        "\"method\":\"verto.media\",\"params\":{\"callID\":\"3c2b1fae\",\"sdp\":\"v=0\\r\\no=FreeSWITCH\\r\\n\"},"
+        "\"esc/key~\":5,\"e\\u0073c\":[]}");
+
+    const json::projection paths{ "/result/sessid", "/params/callID", "/result/list/1/a/1", "/esc~1key~0", "/missing",
+                                  "/id/x", "/result/list", "/result/list/0/a", "/esc", "/result/sessid" };
+    ASSERT_EQ(10, paths.size());
+
+    std::vector<json::value> values;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, paths, values));
+    ASSERT_EQ(10, values.size());
+    ASSERT_EQ("abc", (json::string)values[0]);
+    ASSERT_EQ("3c2b1fae", (json::string)values[1]);
+    ASSERT_EQ(3, (int64_t)values[2]);
+    ASSERT_EQ(5, (int64_t)values[3]);
+    ASSERT_TRUE(values[4].is_null());
+    ASSERT_TRUE(values[5].is_null());
+    ASSERT_EQ(2, std::get<json::arr>(values[6]).size());
+    ASSERT_EQ(1, (int64_t)values[7]);                           // below another path
+    ASSERT_TRUE(values[8].is_array());                          // the escaped key
+    ASSERT_EQ("abc", (json::string)values[9]);
+
+    const json::projection whole{ "" };
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, whole, values));
+    ASSERT_EQ(json::string("verto.media"), (json::string)std::get<json::obj>(values[0])["method"]);
+
+    ASSERT_THROW(json::projection{ "result" }, std::invalid_argument);
+    ASSERT_THROW(json::projection{ "/a~2" }, std::invalid_argument);
+}
+
+TEST(ProjectionCase, test0001_SkippedAndBroken)
+{
+    // the parsing stops once the paths are found, the rest is not looked at
+    const std::string data("{\"a\":{\"b\":\"}\",\"c\":[1,{\"d\":\"]\"}]},\"e\":[1,,],\"f\":2}");
+    std::vector<json::value> values;
+
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, json::projection{ "/a/c/1/d" }, values));
+    ASSERT_EQ("]", (json::string)values[0]);
+
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(data, json::projection{ "/e" }, values));
+
+    // the skipped values are not validated
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, json::projection{ "/f" }, values));
+    ASSERT_EQ(2, (int64_t)values[0]);
+
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"a\":[1,2"), json::projection{ "/b" }, values));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{\"a\" 1}"), json::projection{ "/b" }, values));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{\"a\":1} 2"), json::projection{ "/b" }, values));
+
+    // the escape cut by the end of the input
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"\\"), json::projection{ "/b" }, values));
+    ASSERT_EQ(json::result_t::s_need_more, json::parse(std::string("{\"a\\"), json::projection{ "/b" }, values));
+}
+
+TEST(TapeCase, test0000_Views)
+{
+    const std::string data(
+        "{\"id\":69,\"rate\":-48000,\"ptime\":20.5,\"name\":\"a\\\"b\",\"flags\":[true,false,null],"
+        "\"params\":{\"list\":[[],{},[1,[2]]]},\"empty\":\"\"}");
+
+    json::tape tape;
+    ASSERT_TRUE(tape.empty());
+    ASSERT_EQ(json::result_t::s_done, tape.parse(data));
+    ASSERT_FALSE(tape.empty());
+
+    const json::tape::value_view root = tape.root();
+    ASSERT_TRUE(root.is_object());
+    ASSERT_EQ(7, root.object().size());
+    ASSERT_EQ(69, (int64_t)root["id"]);
+    ASSERT_EQ(-48000, (int64_t)root["rate"]);
+    ASSERT_EQ(20.5, (double)root["ptime"]);
+    ASSERT_EQ("a\"b", (json::string)root["name"]);
+    ASSERT_EQ("", (json::string)root["empty"]);
+    ASSERT_TRUE((bool)root["flags"][0]);
+    ASSERT_FALSE((bool)root["flags"][1]);
+    ASSERT_TRUE(root["flags"][2].is_null());
+    ASSERT_EQ(3, root["params"]["list"].array().size());
+    ASSERT_EQ(2, (int64_t)root["params"]["list"][2][1][0]);
+
+    // the members are in the document order
+    std::string keys;
+    const json::tape::obj_view o = root.object();
+    for (auto it = o.begin(); it != o.end(); ++it)
+        keys += json::string(it.key().data(), it.key().size()) + ",";
+    ASSERT_EQ("id,rate,ptime,name,flags,params,empty,", keys);
+
+    size_t elements = 0;
+    for (const json::tape::value_view element : root["params"]["list"].array())
+        elements += element.is_array() ? 1 : 0;
+    ASSERT_EQ(2, elements);
+
+    ASSERT_THROW(root["missing"], std::out_of_range);
+    ASSERT_THROW(root["flags"][3], std::out_of_range);
+    ASSERT_THROW((int64_t)root["name"], std::logic_error);
+    ASSERT_THROW(root["id"].array(), std::logic_error);
+
+    ASSERT_EQ(json::result_t::e_unexpected, tape.parse(std::string("[1,]")));
+    ASSERT_TRUE(tape.empty());
+    ASSERT_EQ(json::result_t::s_need_more, tape.parse(std::string("[1,")));
+}
+
+TEST(TapeCase, test0001_TreeRoundTrip)
+{
+    const std::string data = make_rpc_batch(16 * 1024);
+
+    json::value tree;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, tree, json::options{ json::engine_t::flat }));
+
+    json::tape parsed;
+    ASSERT_EQ(json::result_t::s_done, parsed.parse(data));
+    ASSERT_EQ(std::get<json::arr>(tree).str(), std::get<json::arr>(parsed.root().to_value()).str());
+
+    json::tape assigned;
+    assigned.assign(tree);
+    ASSERT_EQ(std::get<json::arr>(tree).str(), std::get<json::arr>(assigned.root().to_value()).str());
+
+    json::tape scalar;
+    scalar.assign(json::value(json::string("text")));
+    ASSERT_EQ("text", (json::string)scalar.root());
+}
+
+TEST(ArenaCase, test0000_ScopedAllocator)
+{
+    imalyavskiy::arena memory(4096);
+    ASSERT_EQ(nullptr, imalyavskiy::arena::current());
+
+    arena_json::value jsval;
+    {
+        imalyavskiy::arena_scope scope(memory);
+        ASSERT_EQ(&memory, imalyavskiy::arena::current());
+
+        const std::string data = make_rpc_batch(16 * 1024);
+        ASSERT_EQ(arena_json::result_t::s_done,
+                  arena_json::parse(data.data(), data.size(), jsval, arena_json::options{ arena_json::engine_t::flat }));
+        ASSERT_LT(16 * 1024, memory.allocated());
+        ASSERT_LE(memory.allocated(), memory.reserved());
+
+        {
+            imalyavskiy::arena nested;
+            imalyavskiy::arena_scope inner(nested);
+            ASSERT_EQ(&nested, imalyavskiy::arena::current());
+        }
+        ASSERT_EQ(&memory, imalyavskiy::arena::current());
+    }
+    ASSERT_EQ(nullptr, imalyavskiy::arena::current());
+
+    const arena_json::arr& messages = std::get<arena_json::arr>(jsval);
+    ASSERT_EQ(&memory, messages.get_allocator().get_arena());
+
+    // the copy out of any scope is on the heap and outlives the arena
+    arena_json::arr copy = messages;
+    ASSERT_EQ(nullptr, copy.get_allocator().get_arena());
+    jsval = arena_json::value(nullptr);
+    memory.release();
+    ASSERT_EQ(0, memory.reserved());
+
+    arena_json::obj& params = std::get<arena_json::obj>(std::get<arena_json::obj>(copy[0])["params"]);
+    ASSERT_EQ(48000, (int64_t)params["rate"]);
+    ASSERT_STREQ("3c2b1fae-7665-40e6-b4e1-e61f1b738e8d", ((arena_json::string)params["callID"]).c_str());
+}
+
+TEST(ArenaCase, test0001_Document)
+{
+    const std::string data = make_rpc_batch(64 * 1024);
+
+    json::value expected;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected, json::options{ json::engine_t::flat }));
+
+    for (const bool huge_pages : { false, true })
+    {
+        arena_json::arena_document doc(64 * 1024, huge_pages);
+        ASSERT_TRUE(doc.root().is_null());
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            ASSERT_EQ(arena_json::result_t::s_done, doc.parse(data.data(), data.size()));
+            ASSERT_STREQ(std::get<json::arr>(expected).str().c_str(),
+                         std::get<arena_json::arr>(doc.root()).str().c_str());
+        }
+
+        ASSERT_EQ(arena_json::result_t::e_unexpected, doc.parse("[1,]", 4));
+        ASSERT_TRUE(doc.root().is_null());
+    }
+}
+
+TEST(ArenaCase, test0002_DocumentChanges)
+{
+    arena_json::arena_document doc;
+    ASSERT_THROW(doc.push_back(arena_json::value((int64_t)1)), std::logic_error);
+
+    // the values built on the heap are copied into the arena
+    arena_json::value heap_tree;
+    const std::string data("{\"list\":[1,\"a long enough string to be on the heap\"],\"n\":null}");
+    ASSERT_EQ(arena_json::result_t::s_done,
+              arena_json::parse(data.data(), data.size(), heap_tree, arena_json::options{ arena_json::engine_t::flat }));
+    ASSERT_EQ(nullptr, std::get<arena_json::obj>(heap_tree).get_allocator().get_arena());
+
+    doc.assign(heap_tree);
+    const size_t allocated = doc.get_arena().allocated();
+    ASSERT_LT(0, allocated);
+    heap_tree = arena_json::value(nullptr);
+
+    const arena_json::obj& root = std::get<arena_json::obj>(doc.root());
+    ASSERT_EQ(&doc.get_arena(), root.get_allocator().get_arena());
+    const arena_json::arr& list = std::get<arena_json::arr>(root.at("list"));
+    ASSERT_EQ(&doc.get_arena(), list.get_allocator().get_arena());
+    ASSERT_EQ(&doc.get_arena(), std::get<arena_json::string>(list[1]).get_allocator().get_arena());
+
+    doc.insert("added", arena_json::value(arena_json::string("another long enough string to be on the heap")));
+    ASSERT_THROW(doc.push_back(arena_json::value((int64_t)1)), std::logic_error);
+    ASSERT_LT(allocated, doc.get_arena().allocated());
+    ASSERT_EQ(&doc.get_arena(), std::get<arena_json::string>(root.at("added")).get_allocator().get_arena());
+
+    doc.assign(arena_json::value(arena_json::arr()));
+    doc.push_back(arena_json::value((int64_t)2));
+    ASSERT_STREQ("[2]", std::get<arena_json::arr>(doc.root()).str().c_str());
+}
+
+/// Memory resource counting the bytes allocated through it
+struct counting_resource : std::pmr::memory_resource
+{
+    size_t allocated = 0;
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+};
+
+TEST(PmrCase, test0000_ResourcePropagation)
+{
+    counting_resource parsed_in, copied_in;
+    const std::string data = make_rpc_batch(16 * 1024);
+
+    pmr_json::value jsval;
+    {
+        imalyavskiy::resource_scope scope(&parsed_in);
+        ASSERT_EQ(&parsed_in, imalyavskiy::resource_scope::current());
+        ASSERT_EQ(pmr_json::result_t::s_done,
+                  pmr_json::parse(data.data(), data.size(), jsval, pmr_json::options{ pmr_json::engine_t::flat }));
+    }
+    ASSERT_EQ(std::pmr::get_default_resource(), imalyavskiy::resource_scope::current());
+    ASSERT_LT(16 * 1024, parsed_in.allocated);
+
+    pmr_json::arr& messages = std::get<pmr_json::arr>(jsval);
+    pmr_json::obj& message = std::get<pmr_json::obj>(messages[0]);
+    pmr_json::obj& params = std::get<pmr_json::obj>(message["params"]);
+    ASSERT_EQ(&parsed_in, messages.get_allocator().resource());
+    ASSERT_EQ(&parsed_in, message.get_allocator().resource());
+    ASSERT_EQ(&parsed_in, std::get<pmr_json::string>(params["callID"]).get_allocator().resource());
+
+    // the copy with the other resource passes it down to every nested container
+    const pmr_json::arr copy(messages, &copied_in);
+    ASSERT_LT(16 * 1024, copied_in.allocated);
+    const pmr_json::obj& copied = std::get<pmr_json::obj>(copy[0]);
+    ASSERT_EQ(&copied_in, copied.get_allocator().resource());
+    ASSERT_EQ(&copied_in, std::get<pmr_json::obj>(copied["params"]).get_allocator().resource());
+    ASSERT_EQ(&copied_in, std::get<pmr_json::string>(copied["method"]).get_allocator().resource());
+
+    // the move to the container of the other resource copies to it
+    pmr_json::arr moved(&copied_in);
+    moved.push_back(std::move(messages[1]));
+    ASSERT_EQ(&copied_in, std::get<pmr_json::obj>(moved[0]).get_allocator().resource());
+    ASSERT_EQ(48000, (int64_t)std::get<pmr_json::obj>(std::get<pmr_json::obj>(moved[0])["params"])["rate"]);
+
+    // the move within the resource takes the nodes over
+    const size_t before = parsed_in.allocated;
+    pmr_json::value taken(std::move(messages[2]));
+    ASSERT_EQ(before, parsed_in.allocated);
+    ASSERT_EQ(&parsed_in, std::get<pmr_json::obj>(taken).get_allocator().resource());
+}
+
+TEST(FlatMapCase, test0000_Interface)
+{
+    imalyavskiy::flat_map<std::string, int> m{ { "b", 2 }, { "a", 1 }, { "c", 3 }, { "a", 10 } };
+    ASSERT_EQ(3, m.size());
+    ASSERT_EQ(1, m.at("a"));
+    ASSERT_THROW(m.at("d"), std::out_of_range);
+
+    m["d"] = 4;     // appended
+    m["0"] = 0;     // inserted in front
+    m["b"] = 20;    // overwritten
+    ASSERT_EQ(5, m.size());
+    ASSERT_EQ(20, m["b"]);
+    ASSERT_FALSE(m.insert(std::make_pair(std::string("c"), 30)).second);
+    ASSERT_TRUE(m.emplace("e", 5).second);
+
+    std::string keys;
+    for (const auto& member : m)
+        keys += member.first;
+    ASSERT_EQ("0abcde", keys);
+
+    ASSERT_EQ(1, m.erase("0"));
+    ASSERT_EQ(0, m.erase("0"));
+    ASSERT_TRUE(m.end() == m.find("0"));
+    ASSERT_EQ(1, m.count("e"));
+}
+
+TEST(FlatMapCase, test0001_Document)
+{
+    const std::string data = make_rpc_batch(16 * 1024);
+
+    json::value expected;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, expected, json::options{ json::engine_t::flat }));
+
+    for (const flat_json::engine_t engine : { flat_json::engine_t::automaton, flat_json::engine_t::flat })
+    {
+        flat_json::value jsval;
+        ASSERT_EQ(flat_json::result_t::s_done, flat_json::parse(data, jsval, flat_json::options{ engine }));
+        ASSERT_EQ(std::get<json::arr>(expected).str(), std::get<flat_json::arr>(jsval).str());
+
+        flat_json::obj& params = std::get<flat_json::obj>(std::get<flat_json::obj>(std::get<flat_json::arr>(jsval)[0])["params"]);
+        ASSERT_EQ(48000, (int64_t)params["rate"]);
+        ASSERT_TRUE(params.exists("sdp"));
+        ASSERT_FALSE(params.exists("missing"));
+    }
+
+    const flat_json::obj o{ { "b", flat_json::value((int64_t)2) }, { "a", flat_json::value("1") } };
+    ASSERT_EQ("{\"a\":\"1\",\"b\":2}", o.str());
+}
+
+TEST(HashMapCase, test0000_Interface)
+{
+    imalyavskiy::hash_map<std::string, int> m{ { "b", 2 }, { "a", 1 }, { "b", 20 } };
+    ASSERT_EQ(2, m.size());
+    ASSERT_EQ(2, m.at("b"));
+    ASSERT_THROW(m.at("c"), std::out_of_range);
+
+    // past the threshold the index is built
+    for (int i = 0; i < 1000; ++i)
+        m["key " + std::to_string(i)] = i;
+    ASSERT_EQ(1002, m.size());
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(i, m.at("key " + std::to_string(i)));
+    ASSERT_TRUE(m.end() == m.find("key 1000"));
+    ASSERT_FALSE(m.emplace("key 5", 50).second);
+
+    // the members are in the insertion order
+    ASSERT_EQ("b", m.begin()->first);
+    ASSERT_EQ("key 999", (--m.end())->first);
+
+    ASSERT_EQ(1, m.erase("a"));
+    ASSERT_EQ(0, m.erase("a"));
+    ASSERT_EQ(1001, m.size());
+    ASSERT_EQ("key 0", (++m.begin())->first);
+    for (int i = 0; i < 1000; ++i)
+        ASSERT_EQ(1, m.count("key " + std::to_string(i)));
+
+    const imalyavskiy::hash_map<std::string, int> copy(m);
+    ASSERT_EQ(999, copy.at("key 999"));
+    ASSERT_TRUE(copy == m);
+}
+
+TEST(HashMapCase, test0001_LargeObject)
+{
+    std::string data("{");
+    for (size_t i = 0; i < 10000; ++i)
+        data += (0 != i ? ",\"k" : "\"k") + std::to_string(i * 7919 % 10007) + "\":" + std::to_string(i);
+    data += ",\"k0\":-1}";
+
+    for (const hash_json::engine_t engine : { hash_json::engine_t::automaton, hash_json::engine_t::flat })
+    {
+        hash_json::value jsval;
+        ASSERT_EQ(hash_json::result_t::s_done, hash_json::parse(data, jsval, hash_json::options{ engine }));
+
+        hash_json::obj& o = std::get<hash_json::obj>(jsval);
+        ASSERT_EQ(10000, o.size());
+        ASSERT_EQ(-1, (int64_t)o["k0"]);   // the last duplicate wins
+        for (size_t i = 1; i < 10000; ++i)
+            ASSERT_EQ((int64_t)i, (int64_t)o["k" + std::to_string(i * 7919 % 10007)]);
+        ASSERT_FALSE(o.exists("k10007"));
+
+        // the document order
+        ASSERT_EQ("k7919", (++o.begin())->first);
+    }
+}
+
+TEST(HashMapCase, test0002_ReserveAndErase)
+{
+    // the index built by reserve() takes the members below the threshold as well
+    imalyavskiy::hash_map<std::string, int> m;
+    m.reserve(100);
+    m["a"] = 1;
+    m["a"] = 2;
+    ASSERT_EQ(1, m.size());
+    ASSERT_EQ(2, m.at("a"));
+
+    // the erasure keeps the index and the order of the rest
+    m["a"] = -1;
+    std::map<std::string, int> expected{ { "a", -1 } };
+    for (int i = 0; i < 2000; ++i)
+        m["key " + std::to_string(i)] = expected["key " + std::to_string(i)] = i;
+    for (int i = 0; i < 2000; i += 3)
+    {
+        ASSERT_EQ(1, m.erase("key " + std::to_string(i * 7 % 2000)));
+        expected.erase("key " + std::to_string(i * 7 % 2000));
+    }
+
+    ASSERT_EQ(expected.size(), m.size());
+    for (const auto& member : expected)
+        ASSERT_EQ(member.second, m.at(member.first));
+    for (int i = 0; i < 2000; ++i)
+        ASSERT_EQ(expected.count("key " + std::to_string(i)), m.count("key " + std::to_string(i)));
+
+    int previous = -2;
+    for (const auto& member : m)
+    {
+        ASSERT_LT(previous, member.second);
+        previous = member.second;
+    }
+
+    while (!m.empty())
+        m.erase(m.begin());
+    ASSERT_TRUE(m.end() == m.find("a"));
+    m["b"] = 3;
+    ASSERT_EQ(3, m.at("b"));
+}
+
+TEST(InternTableCase, test0000_Atoms)
+{
+    json::intern_table atoms(16);
+    ASSERT_EQ(0, atoms.size());
+
+    const json::intern_table::atom* const id = atoms.intern("id");
+    ASSERT_NE(nullptr, id);
+    ASSERT_EQ(id, atoms.intern(std::string("id")));
+    ASSERT_EQ(id, atoms.find("id"));
+    ASSERT_EQ("id", id->view());
+    ASSERT_NE(id, atoms.intern("method"));
+    ASSERT_EQ(nullptr, atoms.find("params"));
+    ASSERT_NE(nullptr, atoms.intern(""));
+    ASSERT_EQ(3, atoms.size());
+
+    // the table does not grow past 3/4 of the capacity
+    for (size_t i = 0; i < 16; ++i)
+        atoms.intern("key " + std::to_string(i));
+    ASSERT_EQ(12, atoms.size());
+    ASSERT_EQ(nullptr, atoms.intern("one more"));
+    ASSERT_EQ(id, atoms.intern("id"));
+}
+
+TEST(InternTableCase, test0001_ConcurrentInterning)
+{
+    json::intern_table atoms(4096);
+
+    const size_t threads = 4, keys = 1000;
+    std::vector<std::vector<const json::intern_table::atom*>> interned(threads);
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&atoms, &interned, t]() {
+            // every thread walks the keys in its own order
+            for (size_t i = 0; i < keys; ++i)
+                interned[t].push_back(atoms.intern("key " + std::to_string((i * (2 * t + 1)) % keys)));
+        });
+    }
+    for (std::thread& thread : pool)
+        thread.join();
+
+    ASSERT_EQ(keys, atoms.size());
+    for (size_t t = 0; t < threads; ++t)
+    {
+        for (size_t i = 0; i < keys; ++i)
+            ASSERT_EQ(atoms.find("key " + std::to_string((i * (2 * t + 1)) % keys)), interned[t][i]);
+    }
+}
+
+TEST(InternTableCase, test0002_InternedTape)
+{
+    const std::string data = make_rpc_batch(16 * 1024);
+
+    json::tape plain;
+    ASSERT_EQ(json::result_t::s_done, plain.parse(data));
+
+    json::intern_table atoms;
+    json::tape first(atoms, 8), second(atoms, 8);
+    ASSERT_EQ(json::result_t::s_done, first.parse(data));
+    ASSERT_EQ(json::result_t::s_need_more, second.parse(data.data(), data.size() / 2)); // the atoms stay
+    ASSERT_EQ(json::result_t::s_done, second.parse(std::string("{\"params\":{\"rate\":8000},\"method\":\"x\"}")));
+
+    ASSERT_EQ(std::get<json::arr>(plain.root().to_value()).str(), std::get<json::arr>(first.root().to_value()).str());
+    ASSERT_GT(plain.memory(), first.memory());
+
+    // the keys and the short values are the atoms shared by the tapes
+    const json::intern_table::atom* const params = atoms.find("params");
+    const json::intern_table::atom* const rate = atoms.find("rate");
+    ASSERT_NE(nullptr, params);
+    ASSERT_NE(nullptr, atoms.find("2.0"));
+    ASSERT_EQ(nullptr, atoms.find("verto.media"));
+
+    const json::tape::obj_view message = first.root()[0].object();
+    ASSERT_EQ(params, message.find(params).atom());
+    ASSERT_EQ(48000, (int64_t)message.find(params).value().object().find(rate).value());
+    ASSERT_EQ(8000, (int64_t)second.root().object().find(params).value().object().find(rate).value());
+    ASSERT_EQ("x", (json::string)second.root()["method"]);
+    ASSERT_TRUE(second.root().object().end() == second.root().object().find(atoms.find("id")));
+}
+
+TEST(StringParserCase, test0000_EscapeSequences)
+{
+    const std::string data(
+        "{\"s\":\"q\\\"b\\\\s\\/b\\bf\\fn\\nr\\rt\\tu\\u0041\\u00e9\\u20AC\\ud83d\\ude00\"}");
+    const std::string expected("q\"b\\s/b\bf\fn\nr\rt\tuA\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+
+    json::obj jsobj{};
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsobj));
+    ASSERT_EQ(expected, (json::string)jsobj["s"]);
+
+    // every split point goes through the escape and \\uXXXX states
+    for (size_t split = 1; split < data.size(); ++split)
+    {
+        json::session s(json::create());
+
+        ASSERT_EQ(json::result_t::s_need_more, s.feed(data.data(), split));
+        ASSERT_EQ(json::result_t::s_done, s.feed(data.data() + split, data.size() - split));
+        ASSERT_EQ(expected, (json::string)s.get().get<json::obj>()["s"]);
+    }
+}
+
+TEST(StringParserCase, test0001_LongStringRun)
+{
+    const std::string body(1000, 'z');
+    const std::string data("[\"" + body + "\\n" + body + "\"]");
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+    ASSERT_EQ(body + "\n" + body, (json::string)((json::arr)jsval)[0]);
+
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[\"\\x\"]"), jsval));
+}
+
+TEST(ValueParserCase, test0000_FirstByteDispatch)
+{
+    const std::string data("[null, true, false, \"s\", -1, 2.5, [0], {\"k\":{}}, [], 7]");
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+
+    const json::arr& jsarr = jsval;
+    ASSERT_EQ(10, jsarr.size());
+    ASSERT_EQ(json::null_t(), (json::null_t)jsarr[0]);
+    ASSERT_EQ(true, (json::boolean_t)jsarr[1]);
+    ASSERT_EQ(false, (json::boolean_t)jsarr[2]);
+    ASSERT_EQ("s", (json::string)jsarr[3]);
+    ASSERT_EQ(-1, (json::integer_t)jsarr[4]);
+    ASSERT_EQ(2.5, (json::floatingpt_t)jsarr[5]);
+    ASSERT_EQ(1, ((json::arr)jsarr[6]).size());
+    ASSERT_EQ(1, ((json::obj)jsarr[7]).size());
+    ASSERT_EQ(0, ((json::arr)jsarr[8]).size());
+    ASSERT_EQ(7, (json::integer_t)jsarr[9]);
+
+    // no value starts with these symbols
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[+1]"), jsval));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("[.5]"), jsval));
+    ASSERT_EQ(json::result_t::e_unexpected, json::parse(std::string("{\"k\":x}"), jsval));
+}
+
+TEST(ParseContextCase, test0000_ReuseAcrossDocuments)
+{
+    json::parse_context context;
+
+    json::obj jsobj;
+    ASSERT_EQ(json::result_t::s_done, context.parse(std::string("{\"a\":[1,{\"b\":\"c\"}]}"), jsobj));
+    ASSERT_EQ("c", (json::string)((json::obj)((json::arr)jsobj["a"])[1])["b"]);
+
+    // the failed document leaves the parsers in the middle of nested values
+    ASSERT_EQ(json::result_t::e_unexpected, context.parse(std::string("{\"a\":[1,{\"b\":x}]}"), jsobj));
+    ASSERT_EQ(json::result_t::s_need_more, context.parse(std::string("{\"a\":[1,{\"b\":\"c"), jsobj));
+
+    ASSERT_EQ(json::result_t::s_done, context.parse(std::string("{\"x\":[true,[2.5]],\"y\":{}}"), jsobj));
+    ASSERT_EQ(2, jsobj.size());
+    ASSERT_EQ(2.5, (json::floatingpt_t)((json::arr)((json::arr)jsobj["x"])[1])[0]);
+
+    json::value jsval;
+    ASSERT_EQ(json::result_t::s_done, context.parse(std::string("[\"d\",-7]"), jsval));
+    ASSERT_EQ(-7, (json::integer_t)((json::arr)jsval)[1]);
+    ASSERT_EQ(json::result_t::s_done, context.parse(std::string("42"), jsval));
+    ASSERT_EQ(42, (json::integer_t)jsval);
+}
+
+/// Runs the function the given number of times and returns the throughput in MB/s
+template <class F>
+static double measure_mbps(const size_t bytes, const size_t runs, F f)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < runs; ++i)
+        f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return (double)(bytes * runs) / (1024 * 1024) / elapsed.count();
+}
+
+TEST(BenchmarkCase, DISABLED_test0000_AutomatonVsStructural)
+{
+    const std::string data = make_rpc_batch(4 * 1024 * 1024);
+
+    const double automaton = measure_mbps(data.size(), 3, [&data]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+    });
+
+    const double structural = measure_mbps(data.size(), 3, [&data]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::structural }));
+    });
+
+    const double flat = measure_mbps(data.size(), 3, [&data]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    json::structural_parser_t index_only;
+    const double stage1 = measure_mbps(data.size(), 3, [&data, &index_only]() {
+        ASSERT_EQ(json::result_t::s_ok, index_only.index(data.data(), data.size()));
+    });
+
+    std::cout << "automaton:  " << automaton  << " MB/s" << std::endl;
+    std::cout << "structural: " << structural << " MB/s (x" << structural / automaton << ")" << std::endl;
+    std::cout << "  stage 1:  " << stage1     << " MB/s" << std::endl;
+    std::cout << "flat:       " << flat       << " MB/s (x" << flat / automaton << ")" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0001_AllocationsPerValue)
+{
+    // 12 values: the root object, 7 members of it and of the nested object, 3 array items and the nested object
+    const std::string message(
+        "{\"jsonrpc\":\"2.0\",\"id\":69,\"method\":\"verto.media\",\"params\":"
+        "{\"callID\":\"3c2b1fae\",\"flags\":[true,null,1.5],\"rate\":48000}}");
+    const size_t values = 12;
+    const size_t runs = 10000;
+
+    json::obj jsobj;
+    ASSERT_EQ(json::result_t::s_done, json::parse(message, jsobj));
+
+    // the tree alone: copies of the parsed tree
+    size_t before = g_allocations;
+    for (size_t i = 0; i < runs; ++i)
+        json::obj copy(jsobj);
+    const size_t tree_allocations = g_allocations - before;
+
+    before = g_allocations;
+    const double mbps = measure_mbps(message.size(), runs, [&message]() {
+        json::obj jsobj;
+        ASSERT_EQ(json::result_t::s_done, json::parse(message, jsobj));
+    });
+    const size_t allocations = g_allocations - before;
+
+    json::parse_context context;
+    before = g_allocations;
+    const double context_mbps = measure_mbps(message.size(), runs, [&message, &context]() {
+        json::obj jsobj;
+        ASSERT_EQ(json::result_t::s_done, context.parse(message, jsobj));
+    });
+    const size_t context_allocations = g_allocations - before;
+
+    std::cout << "allocations per value: " << (double)allocations / (runs * values)
+              << " (tree alone: " << (double)tree_allocations / (runs * values) << "), " << mbps << " MB/s" << std::endl;
+    std::cout << "with context:          " << (double)context_allocations / (runs * values)
+              << ", " << context_mbps << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0002_ThroughputByDepth)
+{
+    for (const size_t depth : { 1, 16, 256 })
+    {
+        // the same 1 MB of numbers wrapped into the given number of arrays
+        std::string data(std::string(depth, '[') + "1");
+        while (data.size() < 1024 * 1024)
+            data += ",12345";
+        data += std::string(depth, ']');
+
+        const double automaton = measure_mbps(data.size(), 3, [&data]() {
+            json::value jsval;
+            ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval));
+        });
+
+        const double flat = measure_mbps(data.size(), 3, [&data]() {
+            json::value jsval;
+            ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::flat }));
+        });
+
+        std::cout << "depth " << depth << ": automaton " << automaton << " MB/s, flat " << flat << " MB/s" << std::endl;
+    }
+}
+
+TEST(BenchmarkCase, DISABLED_test0003_Numbers)
+{
+    std::mt19937_64 rng(7);
+    std::uniform_real_distribution<double> lat(-90, 90), lon(-180, 180), metric(0, 1000);
+    char buf[64];
+
+    // GeoJSON like coordinates
+    std::string coordinates("[");
+    while (coordinates.size() < 1024 * 1024)
+    {
+        snprintf(buf, sizeof(buf), "[%.7f,%.7f],", lon(rng), lat(rng));
+        coordinates += buf;
+    }
+    coordinates.back() = ']';
+
+    // telemetry samples: timestamps, counters and full precision readings
+    std::string telemetry("[");
+    for (uint64_t ts = 1500000000000; telemetry.size() < 1024 * 1024; ts += 1000)
+    {
+        snprintf(buf, sizeof(buf), "[%llu,%llu,%.17g,%.3e],", (unsigned long long)ts, (unsigned long long)(rng() % 100000),
+                 metric(rng), metric(rng));
+        telemetry += buf;
+    }
+    telemetry.back() = ']';
+
+    for (const std::string* data : { &coordinates, &telemetry })
+    {
+        const double automaton = measure_mbps(data->size(), 3, [data]() {
+            json::value jsval;
+            ASSERT_EQ(json::result_t::s_done, json::parse(*data, jsval));
+        });
+
+        const double flat = measure_mbps(data->size(), 3, [data]() {
+            json::value jsval;
+            ASSERT_EQ(json::result_t::s_done, json::parse(*data, jsval, json::options{ json::engine_t::flat }));
+        });
+
+        std::cout << (data == &coordinates ? "coordinates" : "telemetry  ") << ": automaton " << automaton
+                  << " MB/s, flat " << flat << " MB/s" << std::endl;
+    }
+}
+
+TEST(BenchmarkCase, DISABLED_test0004_DocumentStream)
+{
+    const std::string message(
+        "{\"jsonrpc\":\"2.0\",\"id\":69,\"method\":\"verto.media\",\"params\":"
+        "{\"callID\":\"3c2b1fae\",\"flags\":[true,null,1.5],\"rate\":48000}}\n");
+    const size_t records = 1000000;
+
+    std::string data;
+    data.reserve(message.size() * records);
+    for (size_t i = 0; i < records; ++i)
+        data += message;
+
+    std::istringstream input(data);
+    json::document_reader reader(input);
+
+    size_t allocations = 0;
+    const double mbps = measure_mbps(data.size(), 1, [&reader, &allocations]() {
+        const size_t before = g_allocations;
+
+        json::value jsval;
+        while (json::result_t::s_done == reader.next(jsval));
+
+        allocations = g_allocations - before;
+    });
+
+    ASSERT_EQ(records, reader.count());
+    std::cout << "records: " << records << ", " << mbps << " MB/s, " << mbps * 1024 * 1024 / message.size()
+              << " records/s, " << (double)allocations / records << " allocations per record" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0005_ParallelNdjson)
+{
+    const std::string data = make_ndjson(1000000);
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+
+    for (const size_t threads : { 1, 2, 4, 8, 16 })
+    {
+        size_t count = 0;
+        const double mbps = measure_mbps(data.size(), 3, [&data, &count, threads]() {
+            count = 0;
+            ASSERT_EQ(json::result_t::s_done, json::parse_ndjson(data.data(), data.size(), [&count](json::value&&) { ++count; }, threads));
+        });
+
+        ASSERT_EQ(1000000, count);
+        std::cout << "threads: " << threads << ", " << mbps << " MB/s" << std::endl;
+    }
+}
+
+TEST(BenchmarkCase, DISABLED_test0006_ParallelDocument)
+{
+    const std::string data = make_huge_array(300000);
+
+    const double flat = measure_mbps(data.size(), 3, [&data]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    std::cout << "size: " << data.size() / (1024 * 1024) << " MB, hardware threads: " << std::thread::hardware_concurrency()
+              << ", flat: " << flat << " MB/s" << std::endl;
+
+    for (const size_t threads : { 1, 2, 4, 8, 16 })
+    {
+        const double mbps = measure_mbps(data.size(), 3, [&data, threads]() {
+            json::value jsval;
+            ASSERT_EQ(json::result_t::s_done, json::parse_parallel(data.data(), data.size(), jsval, threads));
+            ASSERT_EQ(300000, std::get<json::arr>(jsval).size());
+        });
+
+        std::cout << "threads: " << threads << ", " << mbps << " MB/s" << std::endl;
+    }
+}
+
+TEST(BenchmarkCase, DISABLED_test0007_ParseFile)
+{
+    const std::string path("json_bench_file.json");
+    size_t size = 0;
+    {
+        const std::string data = make_huge_array(1000000);
+        std::ofstream(path, std::ios::binary) << data;
+        size = data.size();
+    }
+
+    const double read = measure_mbps(size, 3, [&path]() {
+        std::string data;
+        ASSERT_EQ(0, read_file_data(path, data));
+
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(data, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    const double mapped = measure_mbps(size, 3, [&path]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse_file(path, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    std::remove(path.c_str());
+    std::cout << "size: " << size / (1024 * 1024) << " MB, read to string: " << read << " MB/s, mapped: " << mapped
+              << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0008_BorrowedDocument)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    size_t owning_allocations = 0, borrowed_allocations = 0;
+
+    const double owning = measure_mbps(batch.size(), 5, [&batch, &owning_allocations]() {
+        const size_t before = g_allocations;
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, jsval, json::options{ json::engine_t::flat }));
+        owning_allocations = g_allocations - before;
+    });
+
+    const double borrowed = measure_mbps(batch.size(), 5, [&batch, &borrowed_allocations]() {
+        const size_t before = g_allocations;
+        json::document doc;
+        ASSERT_EQ(json::result_t::s_done, doc.parse(batch.data(), batch.size()));
+        borrowed_allocations = g_allocations - before;
+    });
+
+    std::cout << "owning: " << owning << " MB/s, " << owning_allocations << " allocations; borrowed: " << borrowed
+              << " MB/s, " << borrowed_allocations << " allocations" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0009_Events)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    const double dom = measure_mbps(batch.size(), 5, [&batch]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    const double events = measure_mbps(batch.size(), 5, [&batch]() {
+        rate_sum handler;
+        ASSERT_EQ(json::result_t::s_done, json::parse_events(batch, handler));
+    });
+
+    std::cout << "flat DOM: " << dom << " MB/s, events: " << events << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0010_Reader)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    size_t tokens = 0;
+    const double walk = measure_mbps(batch.size(), 5, [&batch, &tokens]() {
+        json::reader reader(batch.data(), batch.size());
+        for (tokens = 0; json::token_t::end != reader.next(); ++tokens);
+    });
+
+    const double skip = measure_mbps(batch.size(), 5, [&batch]() {
+        json::reader reader(batch.data(), batch.size());
+        reader.next();
+        while (json::token_t::object_begin == reader.next())
+            ASSERT_EQ(json::result_t::s_ok, reader.skip());
+    });
+
+    std::istringstream input(batch);
+    const double stream = measure_mbps(batch.size(), 1, [&input]() {
+        json::reader reader(input);
+        while (json::token_t::end != reader.next());
+    });
+
+    std::cout << "all tokens: " << walk << " MB/s(" << tokens << " tokens), skipping the messages: " << skip
+              << " MB/s, all tokens from a stream: " << stream << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0011_LazyDocument)
+{
+    // a 50 KB response of which 3 fields are read
+    std::string response("{\"status\":\"ok\",\"items\":");
+    response += make_rpc_batch(50 * 1024);
+    response += ",\"total\":123,\"next\":\"cursor\"}";
+
+    const double dom = measure_mbps(response.size(), 200, [&response]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(response, jsval, json::options{ json::engine_t::flat }));
+        ASSERT_EQ(123, (int64_t)std::get<json::obj>(jsval)["total"]);
+    });
+
+    const double lazy = measure_mbps(response.size(), 200, [&response]() {
+        json::lazy_document doc;
+        ASSERT_EQ(json::result_t::s_done, doc.parse(response));
+        ASSERT_EQ("ok", (json::string)doc.root()["status"]);
+        ASSERT_EQ(123, (int64_t)doc.root()["total"]);
+        ASSERT_EQ("cursor", (json::string)doc.root()["next"]);
+    });
+
+    std::cout << "3 fields of " << response.size() / 1024 << " KB: flat DOM " << dom << " MB/s, lazy " << lazy << " MB/s"
+              << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0012_Projection)
+{
+    // the verto message is mostly the SDP blob
+    const std::string sdp(
+        "v=0\\r\\no=FreeSWITCH 1510258435 1510258436 IN IP4 54.202.245.29\\r\\ns=FreeSWITCH\\r\\nc=IN IP4 54.202.245.29"
+        "\\r\\nt=0 0\\r\\na=msid-semantic: WMS qtCaCWAeHZ3OzNlbMKnEIpHtudwz2myj\\r\\nm=audio 29220 UDP/TLS/RTP/SAVPF 111 "
+        "110\\r\\na=rtpmap:111 opus/48000/2\\r\\na=fmtp:111 useinbandfec=1; minptime=10\\r\\n");
+
+    std::string batch("[");
+    for (size_t i = 0; i < 20000; ++i)
+    {
+        batch += "{\"jsonrpc\":\"2.0\",\"id\":" + std::to_string(i) + ",\"method\":\"verto.media\",\"params\":{\"sdp\":\"" +
+                 sdp + "\",\"callID\":\"3c2b1fae-7665-40e6-b4e1-e61f1b738e8d\"}}";
+        batch += ",";
+    }
+    batch.back() = ']';
+
+    const double dom = measure_mbps(batch.size(), 3, [&batch]() {
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, jsval, json::options{ json::engine_t::flat }));
+    });
+
+    const json::projection paths{ "/19999/params/callID", "/19999/id" };
+    const double projected = measure_mbps(batch.size(), 3, [&batch, &paths]() {
+        std::vector<json::value> values;
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, paths, values));
+        ASSERT_EQ(19999, (int64_t)values[1]);
+    });
+
+    std::cout << "flat DOM: " << dom << " MB/s, projection: " << projected << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0013_Tape)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    size_t tree_allocations = 0, tape_allocations = 0;
+
+    json::value tree;
+    const double tree_parse = measure_mbps(batch.size(), 5, [&batch, &tree, &tree_allocations]() {
+        const size_t before = g_allocations;
+        tree = json::value();
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, tree, json::options{ json::engine_t::flat }));
+        tree_allocations = g_allocations - before;
+    });
+
+    json::tape tape;
+    const double tape_parse = measure_mbps(batch.size(), 5, [&batch, &tape, &tape_allocations]() {
+        const size_t before = g_allocations;
+        ASSERT_EQ(json::result_t::s_done, tape.parse(batch));
+        tape_allocations = g_allocations - before;
+    });
+
+    // sum up the rate of every message
+    int64_t tree_sum = 0, tape_sum = 0;
+    const double tree_read = measure_mbps(batch.size(), 20, [&tree, &tree_sum]() {
+        tree_sum = 0;
+        for (const json::value& message : std::get<json::arr>(tree))
+        {
+            const json::obj& params = std::get<json::obj>(std::get<json::obj>(message).at("params"));
+            tree_sum += std::get<int64_t>(params.at("rate"));
+        }
+    });
+
+    const double tape_read = measure_mbps(batch.size(), 20, [&tape, &tape_sum]() {
+        tape_sum = 0;
+        for (const json::tape::value_view message : tape.root().array())
+            tape_sum += (int64_t)message["params"]["rate"];
+    });
+    ASSERT_EQ(tree_sum, tape_sum);
+
+    std::cout << "tree: parse " << tree_parse << " MB/s, " << tree_allocations << " allocations, read " << tree_read
+              << " MB/s; tape: parse " << tape_parse << " MB/s, " << tape_allocations << " allocations, "
+              << tape.memory() / 1024 << " KB, read " << tape_read << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0014_Arena)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    size_t heap_allocations = 0, arena_allocations = 0;
+
+    // the parse and the teardown
+    const double heap = measure_mbps(batch.size(), 5, [&batch, &heap_allocations]() {
+        const size_t before = g_allocations;
+        json::value jsval;
+        ASSERT_EQ(json::result_t::s_done, json::parse(batch, jsval, json::options{ json::engine_t::flat }));
+        heap_allocations = g_allocations - before;
+    });
+
+    const double arena = measure_mbps(batch.size(), 5, [&batch, &arena_allocations]() {
+        const size_t before = g_allocations;
+        arena_json::arena_document doc;
+        ASSERT_EQ(arena_json::result_t::s_done, doc.parse(batch.data(), batch.size()));
+        arena_allocations = g_allocations - before;
+    });
+
+    const double huge = measure_mbps(batch.size(), 5, [&batch]() {
+        arena_json::arena_document doc(2 * 1024 * 1024, true);
+        ASSERT_EQ(arena_json::result_t::s_done, doc.parse(batch.data(), batch.size()));
+    });
+
+    std::cout << "heap: " << heap << " MB/s, " << heap_allocations << " allocations; arena: " << arena << " MB/s, "
+              << arena_allocations << " allocations; arena on huge pages: " << huge << " MB/s" << std::endl;
+}
+
+TEST(BenchmarkCase, DISABLED_test0015_MemoryResources)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    const auto parse_in = [&batch](std::pmr::memory_resource* resource) {
+        imalyavskiy::resource_scope scope(resource);
+        pmr_json::value jsval;
+        ASSERT_EQ(pmr_json::result_t::s_done,
+                  pmr_json::parse(batch.data(), batch.size(), jsval, pmr_json::options{ pmr_json::engine_t::flat }));
+    };
+
+    const double heap = measure_mbps(batch.size(), 5, [&parse_in]() {
+        parse_in(std::pmr::new_delete_resource());
+    });
+
+    const double pool = measure_mbps(batch.size(), 5, [&parse_in]() {
+        std::pmr::unsynchronized_pool_resource resource;
+        parse_in(&resource);
+    });
+
+    const double monotonic = measure_mbps(batch.size(), 5, [&parse_in]() {
+        std::pmr::monotonic_buffer_resource resource;
+        parse_in(&resource);
+    });
+
+    std::cout << "new/delete: " << heap << " MB/s, unsynchronized pool: " << pool << " MB/s, monotonic: " << monotonic
+              << " MB/s" << std::endl;
+}
+
+/// Parses, looks the messages up and serializes the batch by the json_t configuration
+template <class JsonT>
+static void measure_objects(const std::string& batch, double& parse, double& lookup, double& serialize)
+{
+    typename JsonT::value jsval;
+    parse = measure_mbps(batch.size(), 5, [&batch, &jsval]() {
+        jsval = typename JsonT::value();
+        ASSERT_EQ(JsonT::result_t::s_done, JsonT::parse(batch, jsval, typename JsonT::options{ JsonT::engine_t::flat }));
+    });
+
+    int64_t sum = 0;
+    lookup = measure_mbps(batch.size(), 20, [&jsval, &sum]() {
+        for (typename JsonT::value& message : std::get<typename JsonT::arr>(jsval))
+        {
+            typename JsonT::obj& o = std::get<typename JsonT::obj>(message);
+            typename JsonT::obj& params = std::get<typename JsonT::obj>(o["params"]);
+            sum += std::get<int64_t>(params["rate"]) + std::get<int64_t>(o["id"]) + (params.exists("callID") ? 1 : 0);
+        }
+    });
+    ASSERT_LT(0, sum);
+
+    serialize = measure_mbps(batch.size(), 5, [&jsval]() {
+        ASSERT_LT(0, std::get<typename JsonT::arr>(jsval).str().size());
+    });
+}
+
+TEST(BenchmarkCase, DISABLED_test0016_FlatMap)
+{
+    // the serialization copies the nested containers, the batch is kept small
+    const std::string batch = make_rpc_batch(1024 * 1024);
+
+    double map_parse = 0, map_lookup = 0, map_serialize = 0;
+    measure_objects<json>(batch, map_parse, map_lookup, map_serialize);
+
+    double flat_parse = 0, flat_lookup = 0, flat_serialize = 0;
+    measure_objects<flat_json>(batch, flat_parse, flat_lookup, flat_serialize);
+
+    std::cout << "std::map: parse " << map_parse << " MB/s, lookup " << map_lookup << " MB/s, serialize " << map_serialize
+              << " MB/s; flat_map: parse " << flat_parse << " MB/s, lookup " << flat_lookup << " MB/s, serialize "
+              << flat_serialize << " MB/s" << std::endl;
+}
+
+/// Parses the object of the given number of keys by the json_t configuration and looks every key up
+template <class JsonT>
+static void measure_large_object(const std::string& data, const std::vector<std::string>& keys, double& parse, double& lookup)
+{
+    typename JsonT::value jsval;
+    parse = measure_mbps(data.size(), 3, [&data, &jsval]() {
+        jsval = typename JsonT::value();
+        ASSERT_EQ(JsonT::result_t::s_done, JsonT::parse(data, jsval, typename JsonT::options{ JsonT::engine_t::flat }));
+    });
+
+    typename JsonT::obj& o = std::get<typename JsonT::obj>(jsval);
+    int64_t sum = 0;
+    lookup = measure_mbps(data.size(), 3, [&o, &keys, &sum]() {
+        for (const std::string& key : keys)
+            sum += std::get<int64_t>(o.at(key));
+    });
+    ASSERT_LT(0, sum);
+}
+
+TEST(BenchmarkCase, DISABLED_test0017_HashMap)
+{
+    for (const size_t members : { 10000, 1000000 })
+    {
+        std::vector<std::string> keys;
+        std::string data("{");
+        for (size_t i = 0; i < members; ++i)
+        {
+            keys.push_back("member-" + std::to_string(i * 2654435761u % 1000003));
+            data += (0 != i ? ",\"" : "\"") + keys.back() + "\":" + std::to_string(i + 1);
+        }
+        data += "}";
+
+        double map_parse = 0, map_lookup = 0, hash_parse = 0, hash_lookup = 0;
+        measure_large_object<json>(data, keys, map_parse, map_lookup);
+        measure_large_object<hash_json>(data, keys, hash_parse, hash_lookup);
+
+        std::cout << members << " keys, std::map: parse " << map_parse << " MB/s, lookup " << map_lookup
+                  << " MB/s; hash_map: parse " << hash_parse << " MB/s, lookup " << hash_lookup << " MB/s" << std::endl;
+    }
+}
+
+TEST(BenchmarkCase, DISABLED_test0018_InternedKeys)
+{
+    const std::string batch = make_rpc_batch(4 * 1024 * 1024);
+
+    json::tape plain;
+    const double copied = measure_mbps(batch.size(), 5, [&batch, &plain]() {
+        ASSERT_EQ(json::result_t::s_done, plain.parse(batch));
+    });
+
+    json::intern_table atoms;
+    json::tape tape(atoms, 8);
+    const double interned = measure_mbps(batch.size(), 5, [&batch, &tape]() {
+        ASSERT_EQ(json::result_t::s_done, tape.parse(batch));
+    });
+
+    // the lookup of the atom against the one of the string
+    const json::intern_table::atom* const params = atoms.find("params");
+    int64_t by_atom = 0, by_string = 0;
+    const double atom_lookup = measure_mbps(batch.size(), 20, [&tape, params, &by_atom]() {
+        by_atom = 0;
+        for (const json::tape::value_view message : tape.root().array())
+            by_atom += (int64_t)message.object().find(params).value()["rate"];
+    });
+    const double string_lookup = measure_mbps(batch.size(), 20, [&tape, &by_string]() {
+        by_string = 0;
+        for (const json::tape::value_view message : tape.root().array())
+            by_string += (int64_t)message["params"]["rate"];
+    });
+    ASSERT_EQ(by_string, by_atom);
+
+    std::cout << "copied keys: " << copied << " MB/s, " << plain.memory() / 1024 << " KB; interned: " << interned
+              << " MB/s, " << tape.memory() / 1024 << " KB, " << atoms.size() << " atoms; lookup by atom "
+              << atom_lookup << " MB/s, by string " << string_lookup << " MB/s" << std::endl;
+}
 
 int main(int argc, char** argv)
 {